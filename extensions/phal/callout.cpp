@@ -0,0 +1,96 @@
+#include "callout.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <format>
+
+namespace openpower
+{
+namespace pel
+{
+using namespace phosphor::logging;
+
+CalloutPriority getPelPriority(std::string_view phalPriority)
+{
+    for (const auto& [phal, priority] : phalPriorityMap)
+    {
+        if (phal == phalPriority)
+        {
+            return priority;
+        }
+    }
+
+    log<level::ERR>(std::format("Unsupported phal priority({}) is given "
+                                "to get pel priority format",
+                                phalPriority)
+                        .c_str());
+    return CalloutPriority::High;
+}
+
+void sortByPriority(CalloutList& callouts)
+{
+    // TODO: #ibm-openbmc/dev/issues/2595 : Once enabled this support,
+    // callout details is not required to sort in H,M and L orders which
+    // are expected by pel because, pel will take care for sorting callouts
+    // based on priority.
+    std::stable_sort(callouts.begin(), callouts.end(),
+                     [](const Callout& a, const Callout& b) {
+        return a.priority < b.priority;
+    });
+}
+
+nlohmann::json toJson(const CalloutList& callouts)
+{
+    auto jsonCalloutDataList = nlohmann::json::array();
+    for (const auto& callout : callouts)
+    {
+        nlohmann::json jsonCalloutData;
+        auto priority = toString(callout.priority);
+        jsonCalloutData["Priority"] = priority;
+
+        if (callout.procedure)
+        {
+            jsonCalloutData["Procedure"] = *callout.procedure;
+        }
+        if (callout.locationCode)
+        {
+            jsonCalloutData["LocationCode"] = *callout.locationCode;
+        }
+        if (callout.inventoryPath)
+        {
+            jsonCalloutData["InventoryPath"] = *callout.inventoryPath;
+        }
+        if (callout.symbolicFRU)
+        {
+            jsonCalloutData["SymbolicFRU"] = *callout.symbolicFRU;
+        }
+        if (callout.mruId != 0)
+        {
+            jsonCalloutData["MRUs"] = nlohmann::json::array({
+                {{"ID", callout.mruId}, {"Priority", priority}},
+            });
+        }
+        if (callout.deconfigured)
+        {
+            jsonCalloutData["Deconfigured"] = *callout.deconfigured;
+        }
+        if (callout.guarded)
+        {
+            jsonCalloutData["Guarded"] = *callout.guarded;
+        }
+        if (callout.guardType)
+        {
+            jsonCalloutData["GuardType"] = *callout.guardType;
+        }
+        if (callout.entityPath)
+        {
+            jsonCalloutData["EntityPath"] = *callout.entityPath;
+        }
+        jsonCalloutDataList.emplace_back(std::move(jsonCalloutData));
+    }
+    return jsonCalloutDataList;
+}
+
+} // namespace pel
+} // namespace openpower
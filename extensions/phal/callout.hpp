@@ -0,0 +1,116 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace openpower
+{
+namespace pel
+{
+
+/** PEL callout priority, in the order PEL expects the callouts */
+enum class CalloutPriority : uint8_t
+{
+    High,
+    Medium,
+    Low,
+};
+
+/**
+ * pHAL callout priority to PEL callout priority
+ *
+ * @note For "NONE" using Low
+ */
+constexpr std::array<std::pair<std::string_view, CalloutPriority>, 4>
+    phalPriorityMap = {{{"HIGH", CalloutPriority::High},
+                        {"MEDIUM", CalloutPriority::Medium},
+                        {"LOW", CalloutPriority::Low},
+                        {"NONE", CalloutPriority::Low}}};
+
+/**
+ * @brief Get the PEL callout data priority string of a priority
+ *
+ * @param[in] priority - callout priority
+ *
+ * @return "H", "M" or "L"
+ */
+constexpr std::string_view toString(CalloutPriority priority)
+{
+    switch (priority)
+    {
+        case CalloutPriority::High:
+            return "H";
+        case CalloutPriority::Medium:
+            return "M";
+        case CalloutPriority::Low:
+            return "L";
+    }
+    return "H";
+}
+
+/**
+ * @brief Callout to add to a PEL
+ *
+ * Only the set fields are added to the PEL callout data, see
+ * phosphor-logging for their meaning.
+ */
+struct Callout
+{
+    CalloutPriority priority = CalloutPriority::High;
+
+    std::optional<std::string> procedure = std::nullopt;
+    std::optional<std::string> locationCode = std::nullopt;
+    std::optional<std::string> inventoryPath = std::nullopt;
+    std::optional<std::string> symbolicFRU = std::nullopt;
+
+    /** MRU id, added with the callout priority if not 0 */
+    uint32_t mruId = 0;
+
+    std::optional<bool> deconfigured = std::nullopt;
+    std::optional<bool> guarded = std::nullopt;
+    std::optional<std::string> guardType = std::nullopt;
+    std::optional<std::vector<uint8_t>> entityPath = std::nullopt;
+};
+
+using CalloutList = std::vector<Callout>;
+
+/**
+ * @brief GET PEL priority from pHAL priority
+ *
+ * The pHAL callout priority is in different format than PEL format
+ * so, this api is used to return current phal supported priority into
+ * PEL expected format.
+ *
+ * @param[in] phalPriority used to pass phal priority format string
+ *
+ * @return callout priority, High if the phal priority is not supported
+ */
+CalloutPriority getPelPriority(std::string_view phalPriority);
+
+/**
+ * @brief Sort callouts High -> Medium -> Low
+ *
+ * Callouts of the same priority stay in the order given by phal.
+ *
+ * @param[in,out] callouts - callouts to sort
+ */
+void sortByPriority(CalloutList& callouts);
+
+/**
+ * @brief Build the PEL callout data json of callouts
+ *
+ * @param[in] callouts - callouts
+ *
+ * @return json array of the callouts
+ */
+nlohmann::json toJson(const CalloutList& callouts);
+
+} // namespace pel
+} // namespace openpower
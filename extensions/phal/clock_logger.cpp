@@ -14,18 +14,31 @@
  * limitations under the License.
  */
 
+#include "config.h"
+
 #include "extensions/phal/clock_logger.hpp"
 
+#include "extensions/phal/pdbg_utils.hpp"
+#include "parallel_ops.hpp"
 #include "util.hpp"
 
 #include <attributes_info.H>
 #include <libphal.H>
 
+#include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <variant>
 
 using namespace openpower::pel;
 
@@ -35,17 +48,69 @@ namespace openpower::phal::clock
 {
 constexpr auto CLOCK_DAILY_LOGGER_TIMEOUT_IN_HOUR = 24;
 
-Manager::Manager(const sdeventplus::Event& event) :
-    _event(event), timer(event, std::bind(&Manager::timerExpired, this))
+/* Delay of the event triggered sampling, to collect a burst of events once */
+constexpr auto CLOCK_TRIGGER_DELAY = std::chrono::seconds(5);
+
+/* Clock I2C register read size of the chunked fallback read */
+constexpr size_t I2C_READ_SIZE = 0x08;
+
+/* Expected duration of the concurrent processor and clock collection */
+constexpr auto CLOCK_COLLECTION_EXPECTED_TIME = std::chrono::seconds(60);
 
+Manager::Manager(const sdeventplus::Event& event) :
+    _event(event), timer(event, std::bind(&Manager::timerExpired, this)),
+    triggerTimer(event, [this](Timer&) { collect(triggerReason); }),
+    historySignal(event, SIGUSR1,
+                  [this](sdeventplus::source::Signal&,
+                         const struct signalfd_siginfo*) { dumpHistory(); })
 {
+    loadClockRegSnapshot();
+
+    auto& bus = openpower::util::getBus();
+    namespace rules = sdbusplus::bus::match::rules;
+    constexpr auto operationalStatusInterface =
+        "xyz.openbmc_project.State.Decorator.OperationalStatus";
+
+    // Collect the clock data close to host state transitions
+    matches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        rules::propertiesChanged("/xyz/openbmc_project/state/host0",
+                                 "xyz.openbmc_project.State.Host"),
+        [this](sdbusplus::message_t& msg) {
+        try
+        {
+            std::string interface;
+            std::map<std::string, std::variant<std::string>> properties;
+            msg.read(interface, properties);
+            if (properties.contains("CurrentHostState"))
+            {
+                scheduleCollection("Host state change");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error("Failed to read host state change ({ERROR})", "ERROR", e);
+        }
+    }));
+
+    // and to functional state changes, the inventory mirrors HWAS_STATE
+    matches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        rules::type::signal() + rules::member("PropertiesChanged") +
+            rules::interface("org.freedesktop.DBus.Properties") +
+            rules::path_namespace("/xyz/openbmc_project/inventory") +
+            rules::argN(0, operationalStatusInterface),
+        [this](sdbusplus::message_t&) {
+        scheduleCollection("Functional state change");
+    }));
+
     try
     {
         // pdbg initialisation
         openpower::phal::pdbg::init();
 
         // Create clock data log.
-        createClockDataLog();
+        collect("Service start");
     }
     catch (const std::exception& e)
     {
@@ -57,18 +122,53 @@ Manager::Manager(const sdeventplus::Event& event) :
 
 void Manager::addTimer()
 {
-    // Set timer for 24 hours.
-    timer.restart(std::chrono::hours(CLOCK_DAILY_LOGGER_TIMEOUT_IN_HOUR));
+    // Set timer for the sampling interval.
+    timer.restart(std::chrono::minutes(CLOCK_LOGGER_SAMPLE_MINUTES));
 }
 
 void Manager::timerExpired()
 {
-    info("Clock daily logging started");
+    info("Clock periodic sampling started");
 
+    collect("Periodic");
+}
+
+void Manager::scheduleCollection(const std::string& reason)
+{
+    triggerReason = reason;
+    triggerTimer.restartOnce(CLOCK_TRIGGER_DELAY);
+}
+
+void Manager::collect(const std::string& reason)
+{
     try
     {
-        // Create clock data log.
-        createClockDataLog();
+        auto snapshot = collectClockData(reason);
+
+        bool logIt = !lastLogTime ||
+                     (std::chrono::steady_clock::now() - *lastLogTime >=
+                      std::chrono::hours(CLOCK_DAILY_LOGGER_TIMEOUT_IN_HOUR));
+        if (!history.empty() &&
+            (history.back().functional != snapshot.functional))
+        {
+            info("Clock or processor functional state changed");
+            snapshot.reason += ", functional state changed";
+            logIt = true;
+        }
+
+        if (logIt)
+        {
+            // Create clock data log.
+            createClockDataLog(snapshot);
+        }
+
+        publishStatus(snapshot);
+
+        history.push_back(std::move(snapshot));
+        if (history.size() > CLOCK_HISTORY_SIZE)
+        {
+            history.pop_front();
+        }
     }
     catch (const std::exception& e)
     {
@@ -76,182 +176,552 @@ void Manager::timerExpired()
     }
 }
 
-void Manager::createClockDataLog()
+void Manager::createClockDataLog(const ClockSnapshot& snapshot)
 {
-    // Data logger storage
-    FFDCData clockDataLog;
+    auto clockDataLog = snapshot.data;
+    clockDataLog.emplace_back("COLLECTION_REASON", snapshot.reason);
 
-    struct pdbg_target* procTarget;
-    ATTR_HWAS_STATE_Type hwasState;
-    pdbg_for_each_class_target("proc", procTarget)
+    if (!openpower::pel::createPEL("org.open_power.PHAL.Info.ClockDailyLog",
+                                   clockDataLog, Severity::Informational,
+                                   {snapshot.registers}))
     {
-        if (DT_GET_PROP(ATTR_HWAS_STATE, procTarget, hwasState))
+        // Dropped by the rate limit, keep comparing against the registers
+        // which were actually logged.
+        info("Clock data log dropped by the rate limit ({REASON})", "REASON",
+             snapshot.reason);
+        return;
+    }
+    lastLogTime = std::chrono::steady_clock::now();
+
+    // The registers of the next snapshots are compared to the logged ones
+    if (!snapshot.clockRegs.empty())
+    {
+        for (const auto& [path, regs] : snapshot.clockRegs)
         {
-            error("{TARGET} Could not read HWAS_STATE attribute", "TARGET",
-                  pdbg_target_path(procTarget));
-            continue;
+            clockRegSnapshot[path] = regs;
         }
-        if (!hwasState.present)
+        saveClockRegSnapshot();
+    }
+}
+
+void Manager::dumpHistory() const
+{
+    info("Clock data history, {COUNT} snapshots", "COUNT", history.size());
+    for (const auto& snapshot : history)
+    {
+        std::string data;
+        for (const auto& [key, value] : snapshot.data)
         {
-            continue;
+            data += std::format("{}={}; ", key, value);
         }
+        info("Clock data at {TIME} ({REASON}): {DATA}", "TIME",
+             std::format("{:%F %T}", std::chrono::floor<std::chrono::seconds>(
+                                         snapshot.time)),
+             "REASON", snapshot.reason, "DATA", data);
+    }
+}
+
+/**
+ * @brief Data collected from one processor
+ */
+struct ProcClockData
+{
+    /** Log key of the processor */
+    std::string key;
 
-        auto index = std::to_string(pdbg_target_index(procTarget));
+    /** Set if the processor is present */
+    bool present = false;
 
-        // update functional State
-        std::string funState = "Non Functional";
+    /** Processor functional state */
+    bool functional = false;
+
+    /** Collected data, in log order */
+    openpower::pel::FFDCData data;
 
-        if (hwasState.functional)
+    /** Processor state published to the status file */
+    nlohmann::json status;
+
+    /** CFAM register values */
+    FFDCSection registers{FFDCSectionType::Registers};
+};
+
+/**
+ * @brief Collect the clock data of one processor
+ *
+ * Runs on a collection worker thread, it only touches its own target.
+ *
+ * @param[in] procTarget - pdbg processor target
+ *
+ * @return processor data
+ */
+static ProcClockData collectProcData(struct pdbg_target* procTarget)
+{
+    ProcClockData procData;
+    auto& clockDataLog = procData.data;
+
+    ATTR_HWAS_STATE_Type hwasState;
+    if (DT_GET_PROP(ATTR_HWAS_STATE, procTarget, hwasState))
+    {
+        error("{TARGET} Could not read HWAS_STATE attribute", "TARGET",
+              pdbg_target_path(procTarget));
+        return procData;
+    }
+    if (!hwasState.present)
+    {
+        return procData;
+    }
+
+    auto index = std::to_string(pdbg_target_index(procTarget));
+
+    // update functional State
+    std::string funState = "Non Functional";
+
+    if (hwasState.functional)
+    {
+        funState = "Functional";
+    }
+    std::stringstream ssState;
+    ssState << "Proc" << index;
+    clockDataLog.push_back(std::make_pair(ssState.str(), funState));
+    procData.key = ssState.str();
+    procData.present = true;
+    procData.functional = hwasState.functional;
+    procData.status["functional"] = hwasState.functional;
+
+    // update location code information
+    ATTR_LOCATION_CODE_Type locationCode;
+    memset(&locationCode, '\0', sizeof(locationCode));
+    try
+    {
+        openpower::phal::pdbg::getLocationCode(procTarget, locationCode);
+    }
+    catch (const std::exception& e)
+    {
+        error("getLocationCode on {TARGET} thrown exception ({ERROR})",
+              "TARGET", pdbg_target_path(procTarget), "ERROR", e);
+    }
+    std::stringstream ssLoc;
+    ssLoc << "Proc" << index << " Location Code";
+    clockDataLog.push_back(std::make_pair(ssLoc.str(), locationCode));
+    procData.status["locationCode"] = locationCode;
+
+    // Update Processor EC level
+    ATTR_EC_Type ecVal = 0;
+    if (DT_GET_PROP(ATTR_EC, procTarget, ecVal))
+    {
+        error("Could not read ATTR_EC  attribute");
+    }
+    std::stringstream ssEC;
+    ssEC << "Proc" << index << " EC";
+
+    std::stringstream ssECVal;
+    ssECVal << "0x" << std::setfill('0') << std::setw(10) << std::hex
+            << (uint16_t)ecVal;
+    clockDataLog.push_back(std::make_pair(ssEC.str(), ssECVal.str()));
+    procData.status["ec"] = ssECVal.str();
+
+    // Add CFAM register information.
+    Manager::addCFAMData(procTarget, procData.registers,
+                         procData.status["cfam"]);
+
+    return procData;
+}
+
+ClockSnapshot Manager::collectClockData(const std::string& reason)
+{
+    // Data logger storage
+    ClockSnapshot snapshot;
+    snapshot.time = std::chrono::system_clock::now();
+    snapshot.reason = reason;
+    auto& clockDataLog = snapshot.data;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<struct pdbg_target*> procs;
+    struct pdbg_target* procTarget;
+    pdbg_for_each_class_target("proc", procTarget)
+    {
+        procs.push_back(procTarget);
+    }
+
+    // The processors are on separate FSI links, collect them concurrently
+    // and merge the data in target order. The shared FSI ancestors are
+    // probed first, one processor at a time.
+    openpower::phal::probeProcTargets(procs);
+    auto results = openpower::util::runParallel(procs, collectProcData,
+                                                CLOCK_COLLECTION_EXPECTED_TIME);
+    for (size_t i = 0; i < procs.size(); i++)
+    {
+        auto& result = results[i];
+        if (result.timedOut)
         {
-            funState = "Functional";
+            warning("{TARGET} clock data collection took longer than "
+                    "expected",
+                    "TARGET", pdbg_target_path(procs[i]));
         }
-        std::stringstream ssState;
-        ssState << "Proc" << index;
-        clockDataLog.push_back(std::make_pair(ssState.str(), funState));
-
-        // update location code information
-        ATTR_LOCATION_CODE_Type locationCode;
-        memset(&locationCode, '\0', sizeof(locationCode));
-        try
+        if (!result.value)
         {
-            openpower::phal::pdbg::getLocationCode(procTarget, locationCode);
+            error("{TARGET} clock data collection failed", "TARGET",
+                  pdbg_target_path(procs[i]));
+            clockDataLog.emplace_back(
+                std::format("Proc{}", pdbg_target_index(procs[i])),
+                "Collection failed");
+            snapshot.status["procs"][std::to_string(
+                pdbg_target_index(procs[i]))]["collection"] = "failed";
+            continue;
         }
-        catch (const std::exception& e)
+        if (!result.value->present)
         {
-            error("getLocationCode on {TARGET} thrown exception ({ERROR})",
-                  "TARGET", pdbg_target_path(procTarget), "ERROR", e);
+            continue;
         }
-        std::stringstream ssLoc;
-        ssLoc << "Proc" << index << " Location Code";
-        clockDataLog.push_back(std::make_pair(ssLoc.str(), locationCode));
-
-        // Update Processor EC level
-        ATTR_EC_Type ecVal = 0;
-        if (DT_GET_PROP(ATTR_EC, procTarget, ecVal))
+        snapshot.functional[result.value->key] = result.value->functional;
+        snapshot.status["procs"][std::to_string(
+            pdbg_target_index(procs[i]))] = std::move(result.value->status);
+        std::move(result.value->data.begin(), result.value->data.end(),
+                  std::back_inserter(clockDataLog));
+        if (!snapshot.registers.append(result.value->registers))
         {
-            error("Could not read ATTR_EC  attribute");
+            error("{TARGET} CFAM registers left out of the clock data log",
+                  "TARGET", pdbg_target_path(procs[i]));
         }
-        std::stringstream ssEC;
-        ssEC << "Proc" << index << " EC";
-
-        std::stringstream ssECVal;
-        ssECVal << "0x" << std::setfill('0') << std::setw(10) << std::hex
-                << (uint16_t)ecVal;
-        clockDataLog.push_back(std::make_pair(ssEC.str(), ssECVal.str()));
-
-        // Add CFAM register information.
-        addCFAMData(procTarget, clockDataLog);
     }
 
     // Add clock register information
-    addClockRegData(clockDataLog);
+    addClockRegData(snapshot);
 
-    openpower::pel::createPEL("org.open_power.PHAL.Info.ClockDailyLog",
-                              clockDataLog, Severity::Informational);
+    snapshot.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    return snapshot;
 }
 
-void Manager::addCFAMData(struct pdbg_target* proc,
-                          openpower::pel::FFDCData& clockDataLog)
+void Manager::addCFAMData(struct pdbg_target* proc, FFDCSection& registers,
+                          nlohmann::json& cfamStatus)
 {
     // collect Processor CFAM register data
-    const std::vector<int> procCFAMAddr = {
+    constexpr std::array<uint32_t, 9> procCFAMAddr = {
         0x1007, 0x2804, 0x2810, 0x2813, 0x2814, 0x2815, 0x2816, 0x281D, 0x281E};
 
     auto index = std::to_string(pdbg_target_index(proc));
 
-    for (int addr : procCFAMAddr)
+    // The FSI target is resolved and probed once for the whole block
+    std::vector<std::optional<uint32_t>> vals;
+    if (openpower::phal::getCFAMs(proc, procCFAMAddr, vals))
     {
-        auto val = 0xDEADBEEF;
-        try
+        error("getCFAMs on {TARGET} failed, unread registers are logged as "
+              "0xDEADBEEF",
+              "TARGET", pdbg_target_path(proc));
+    }
+
+    for (size_t i = 0; i < procCFAMAddr.size(); i++)
+    {
+        auto val = vals[i].value_or(0xDEADBEEF);
+        // update the data
+        registers.addRegister("Proc" + index, procCFAMAddr[i], val);
+        cfamStatus[std::format("0x{:x}", procCFAMAddr[i])] =
+            std::format("0x{:08x}", val);
+    }
+}
+
+/**
+ * @brief Read the whole clock register space
+ *
+ * The register space is read in one transfer, with a fallback to
+ * I2C_READ_SIZE chunks when the I2C master rejects the large transfer.
+ *
+ * @param[in] clockTarget - pdbg clock target
+ * @param[out] regs - register values
+ *
+ * @return true if all the registers were read
+ */
+static bool readClockRegs(struct pdbg_target* clockTarget,
+                          std::array<uint8_t, CLOCK_REG_SPACE_SIZE>& regs)
+{
+    regs.fill(0);
+    if (i2c_read(clockTarget, 0, 0, regs.size(), regs.data()) == 0)
+    {
+        return true;
+    }
+
+    bool complete = true;
+    for (size_t addr = 0; addr < regs.size(); addr += I2C_READ_SIZE)
+    {
+        auto i2cRc = i2c_read(clockTarget, 0, addr, I2C_READ_SIZE,
+                              regs.data() + addr);
+        if (i2cRc)
         {
-            val = openpower::phal::pdbg::getCFAM(proc, addr);
+            error("({TARGET}) I2C read error({ERROR}) reported {ADDRESS} ",
+                  "TARGET", pdbg_target_path(clockTarget), "ERROR", i2cRc,
+                  "ADDRESS", addr);
+            complete = false;
         }
-        catch (const std::exception& e)
+    }
+    return complete;
+}
+
+/**
+ * @brief Get a digest of the clock registers
+ *
+ * FNV-1a, only used to tell register snapshots apart in the log.
+ *
+ * @param[in] regs - register values
+ *
+ * @return digest
+ */
+static uint32_t getClockRegsDigest(const std::vector<uint8_t>& regs)
+{
+    uint32_t digest = 0x811C9DC5;
+    for (auto byte : regs)
+    {
+        digest = (digest ^ byte) * 0x01000193;
+    }
+    return digest;
+}
+
+void Manager::loadClockRegSnapshot()
+{
+    std::ifstream file(CLOCK_REG_SNAPSHOT_FILE);
+    if (!file)
+    {
+        // First run, all the registers are logged
+        return;
+    }
+
+    try
+    {
+        auto snapshot = nlohmann::json::parse(file);
+        for (const auto& [path, regs] : snapshot.items())
         {
-            error("getCFAM on {TARGET} thrown exception({ERROR}): Addr ({REG})",
-                  "TARGET", pdbg_target_path(proc), "ERROR", e, "REG", addr);
+            clockRegSnapshot[path] = regs.get<std::vector<uint8_t>>();
         }
-        std::stringstream ssData;
-        ssData << "0x" << std::setfill('0') << std::setw(8) << std::hex << val;
-        std::stringstream ssAddr;
-        ssAddr << "Proc" << index << " REG 0x" << std::hex << addr;
-        // update the data
-        clockDataLog.push_back(make_pair(ssAddr.str(), ssData.str()));
+    }
+    catch (const std::exception& e)
+    {
+        error("Ignoring clock register snapshot ({ERROR})", "ERROR", e);
+        clockRegSnapshot.clear();
+    }
+}
+
+/**
+ * @brief Write a JSON file atomically
+ *
+ * The file is written to a temporary file first, so readers never see a
+ * partly written file. Throws std::exception on failure.
+ *
+ * @param[in] path - file path
+ * @param[in] data - file content
+ */
+static void writeJsonFile(const std::filesystem::path& path,
+                          const nlohmann::json& data)
+{
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+
+    std::filesystem::create_directories(path.parent_path());
+    {
+        std::ofstream file(tmpPath);
+        file << data;
+        file.close();
+        if (!file)
+        {
+            throw std::runtime_error(
+                std::format("Failed to write ({})", tmpPath.string()));
+        }
+    }
+    std::filesystem::rename(tmpPath, path);
+}
+
+void Manager::saveClockRegSnapshot()
+{
+    try
+    {
+        writeJsonFile(CLOCK_REG_SNAPSHOT_FILE,
+                      nlohmann::json(clockRegSnapshot));
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to save clock register snapshot ({ERROR})", "ERROR", e);
     }
 }
 
-void Manager::addClockRegData(openpower::pel::FFDCData& clockDataLog)
+void Manager::publishStatus(const ClockSnapshot& snapshot)
+{
+    auto status = snapshot.status;
+    status["timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(
+                              snapshot.time.time_since_epoch())
+                              .count();
+    status["durationMs"] = snapshot.duration.count();
+    status["reason"] = snapshot.reason;
+
+    try
+    {
+        writeJsonFile(CLOCK_STATUS_FILE, status);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to publish clock status ({ERROR})", "ERROR", e);
+    }
+}
+
+/**
+ * @brief Registers read from one clock
+ */
+struct ClockRegRead
+{
+    /** Set if the clock is present */
+    bool present = false;
+
+    /** Clock functional state */
+    bool functional = false;
+
+    /** Set if the clock target probed enabled */
+    bool enabled = false;
+
+    /** Set if all the registers were read */
+    bool complete = false;
+
+    /** Register values */
+    std::vector<uint8_t> regs;
+};
+
+/**
+ * @brief Read the state and the registers of one clock
+ *
+ * Runs on a collection worker thread, it only touches its own target.
+ *
+ * @param[in] clockTarget - pdbg clock target
+ *
+ * @return clock registers
+ */
+static ClockRegRead readClock(struct pdbg_target* clockTarget)
+{
+    ClockRegRead clock;
+
+    ATTR_HWAS_STATE_Type hwasState;
+    if (DT_GET_PROP(ATTR_HWAS_STATE, clockTarget, hwasState))
+    {
+        error("({TARGET}) Could not read HWAS_STATE attribute", "TARGET",
+              pdbg_target_path(clockTarget));
+        return clock;
+    }
+
+    clock.present = hwasState.present;
+    clock.functional = hwasState.functional;
+    if (!clock.present)
+    {
+        return clock;
+    }
+
+    auto status = pdbg_target_probe(clockTarget);
+    if (status != PDBG_TARGET_ENABLED)
+    {
+        return clock;
+    }
+    clock.enabled = true;
+
+    // Update Buffer with clock I2C register data.
+    std::array<uint8_t, CLOCK_REG_SPACE_SIZE> data;
+    clock.complete = readClockRegs(clockTarget, data);
+    clock.regs.assign(data.begin(), data.end());
+    return clock;
+}
+
+void Manager::addClockRegData(ClockSnapshot& snapshot)
 {
     info("Adding clock register information to daily logger");
 
+    std::vector<struct pdbg_target*> clocks;
     struct pdbg_target* clockTarget;
     pdbg_for_each_class_target("oscrefclk", clockTarget)
     {
-        ATTR_HWAS_STATE_Type hwasState;
-        if (DT_GET_PROP(ATTR_HWAS_STATE, clockTarget, hwasState))
+        clocks.push_back(clockTarget);
+        // libpdbg is not thread safe, probe before the concurrent reads
+        pdbg_target_probe(clockTarget);
+    }
+
+    // Read the clocks concurrently, the data is merged in target order
+    auto results = openpower::util::runParallel(clocks, readClock,
+                                                CLOCK_COLLECTION_EXPECTED_TIME);
+
+    auto& clockDataLog = snapshot.data;
+    for (size_t i = 0; i < clocks.size(); i++)
+    {
+        auto index = std::to_string(pdbg_target_index(clocks[i]));
+        // Add clcok device path information
+        std::string path = pdbg_target_path(clocks[i]);
+
+        auto& result = results[i];
+        if (result.timedOut)
+        {
+            warning("({TARGET}) clock register read took longer than "
+                    "expected",
+                    "TARGET", path);
+        }
+        if (!result.value)
         {
-            error("({TARGET}) Could not read HWAS_STATE attribute", "TARGET",
-                  pdbg_target_path(clockTarget));
+            error("({TARGET}) clock register read failed", "TARGET", path);
+            clockDataLog.emplace_back(std::format("Clock{}", index),
+                                      "Collection failed");
+            snapshot.status["clocks"][index]["collection"] = "failed";
             continue;
         }
 
-        if (!hwasState.present)
+        auto& clock = *result.value;
+        if (!clock.present)
         {
             continue;
         }
 
         std::string funState = "Non Functional";
 
-        if (hwasState.functional)
+        if (clock.functional)
         {
             funState = "Functional";
         }
 
-        auto index = std::to_string(pdbg_target_index(clockTarget));
+        clockDataLog.emplace_back(std::format("Clock{}", index), funState);
+        snapshot.functional[std::format("Clock{}", index)] = clock.functional;
 
-        std::stringstream ssState;
-        ssState << "Clock" << index;
-        clockDataLog.push_back(std::make_pair(ssState.str(), funState));
+        clockDataLog.emplace_back(std::format("Clock{} path", index), path);
 
-        // Add clcok device path information
-        std::stringstream ssName;
-        ssName << "Clock" << index << " path";
-        clockDataLog.push_back(
-            std::make_pair(ssName.str(), pdbg_target_path(clockTarget)));
+        auto& clockStatus = snapshot.status["clocks"][index];
+        clockStatus["functional"] = clock.functional;
+        clockStatus["path"] = path;
 
-        auto status = pdbg_target_probe(clockTarget);
-        if (status != PDBG_TARGET_ENABLED)
+        if (!clock.enabled)
         {
             continue;
         }
 
-        // Update Buffer with clock I2C register data.
-        auto constexpr I2C_READ_SIZE = 0x08;
-        auto constexpr I2C_ADDR_MAX = 0xFF;
+        auto& regs = clock.regs;
+        auto digest = getClockRegsDigest(regs);
+        clockStatus["regsDigest"] = std::format("0x{:08x}", digest);
+        clockStatus["regsComplete"] = clock.complete;
 
-        for (auto addr = 0; addr <= I2C_ADDR_MAX; addr += I2C_READ_SIZE)
+        auto last = clockRegSnapshot.find(path);
+        if (clock.complete && (last != clockRegSnapshot.end()) &&
+            (last->second == regs))
         {
-            std::stringstream ssData;
+            // Same as the last logged registers, only log the digest
+            clockDataLog.emplace_back(std::format("Clock{} regs", index),
+                                      std::format("unchanged 0x{:08x}",
+                                                  digest));
+            continue;
+        }
 
-            uint8_t data[0x8];
-            auto i2cRc = i2c_read(clockTarget, 0, addr, I2C_READ_SIZE, data);
-            if (i2cRc)
-            {
-                error("({TARGET}) I2C read error({ERROR}) reported {ADDRESS} ",
-                      "TARGET", pdbg_target_path(clockTarget), "ERROR", i2cRc,
-                      "ADDRESS", addr);
-                continue;
-            }
+        clockDataLog.emplace_back(std::format("Clock{} regs", index),
+                                  std::format("{} 0x{:08x}",
+                                              clock.complete ? "full"
+                                                             : "partial",
+                                              digest));
+        if (!snapshot.registers.addRegister("Clock" + index, 0, regs))
+        {
+            error("({TARGET}) registers left out of the clock data log",
+                  "TARGET", path);
+        }
 
-            for (auto i = 0; i < I2C_READ_SIZE; i++)
-            {
-                ssData << " " << std::hex << std::setfill('0') << std::setw(2)
-                       << (uint16_t)data[i];
-            }
-            std::stringstream ssAddr;
-            ssAddr << "Clock" << index << "_0x" << std::hex << std::setfill('0')
-                   << std::setw(2) << addr;
-            clockDataLog.push_back(make_pair(ssAddr.str(), ssData.str()));
+        // An incomplete read is logged in full again next time
+        if (clock.complete)
+        {
+            snapshot.clockRegs[path] = std::move(regs);
         }
     }
 }
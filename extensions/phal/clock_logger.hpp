@@ -17,19 +17,73 @@
 
 #include "extensions/phal/create_pel.hpp"
 
+#include <sdbusplus/bus/match.hpp>
+#include <sdeventplus/source/signal.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace openpower::phal::clock
 {
 
+/* Size of the clock I2C register space */
+constexpr size_t CLOCK_REG_SPACE_SIZE = 0x100;
+
+/* Number of clock data snapshots kept in memory */
+constexpr size_t CLOCK_HISTORY_SIZE = 16;
+
 /* Dbus event timer */
 using Timer = sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>;
 
+/**
+ * @brief Clock data collected at one point in time
+ */
+struct ClockSnapshot
+{
+    /** Collection time */
+    std::chrono::system_clock::time_point time;
+
+    /** Why the data was collected */
+    std::string reason;
+
+    /** Collected data, as added to the clock data log */
+    openpower::pel::FFDCData data;
+
+    /** Functional state of the present procs and clocks, by log key */
+    std::map<std::string, bool> functional;
+
+    /** Completely read clock registers, by clock device tree path */
+    std::map<std::string, std::vector<uint8_t>> clockRegs;
+
+    /** Collection duration */
+    std::chrono::milliseconds duration{};
+
+    /** Processor and clock state published to the status file */
+    nlohmann::json status;
+
+    /** CFAM and clock register values, logged as binary FFDC */
+    openpower::pel::FFDCSection registers{
+        openpower::pel::FFDCSectionType::Registers};
+};
+
 /**
  * @class Manager - Represents the clock daily management functions
  *
+ * The clock data is sampled every CLOCK_LOGGER_SAMPLE_MINUTES, and
+ * shortly after the host state or the functional state of an inventory
+ * item changed. The recent samples are kept in memory and written to
+ * the journal on SIGUSR1, the latest one is published to the
+ * CLOCK_STATUS_FILE. A clock data log PEL is only created once a
+ * day, and when the functional state of a processor or clock changed
+ * since the previous sample.
  */
 class Manager
 {
@@ -44,6 +98,7 @@ class Manager
     /**
      * Constructor
      * Starts the functions required to capture clock daily logger data.
+     * SIGUSR1 must be blocked by the caller.
      *
      * @param[in] event - sdeventplus event loop
      */
@@ -59,33 +114,120 @@ class Manager
      */
     void timerExpired();
 
+    /**
+     * @brief Collect the clock data, log it if needed
+     *
+     * @param[in] reason - why the data is collected
+     */
+    void collect(const std::string& reason);
+
+    /**
+     * @brief Collect the clock data after a short delay
+     *
+     * Events in a burst are collected once.
+     *
+     * @param[in] reason - why the data is collected
+     */
+    void scheduleCollection(const std::string& reason);
+
+    /**
+     * @brief utility function to collect clock data
+     *
+     * @param[in] reason - why the data is collected
+     *
+     * @return clock data snapshot
+     */
+    ClockSnapshot collectClockData(const std::string& reason);
+
     /**
      * @brief utility function to create clock data log
+     *
+     * The logged registers and the last log time are only updated when
+     * the PEL is created, not when the rate limit drops it.
+     *
+     * @param[in] snapshot - clock data to log
      */
-    void createClockDataLog();
+    void createClockDataLog(const ClockSnapshot& snapshot);
+
+    /**
+     * @brief Write the clock data history to the journal
+     */
+    void dumpHistory() const;
 
     /**
      * @brief Add processor specific CFAM data to daily logger.
      *
+     * Called concurrently for the processors, it doesn't use any state.
+     *
      * @param[in] proc - pdbg processor target
-     * @param[out] ffdcData - reference to clock data log
+     * @param[out] registers - binary FFDC section of the register values
+     * @param[out] cfamStatus - CFAM register values by address
      */
-    void addCFAMData(struct pdbg_target* proc,
-                     openpower::pel::FFDCData& clockDataLog);
+    static void addCFAMData(struct pdbg_target* proc,
+                            openpower::pel::FFDCSection& registers,
+                            nlohmann::json& cfamStatus);
 
     /**
      * @brief Add clock specific register data to daily logger.
      *
-     * @param[out] ffdcData - reference to clock data log
+     * The clocks are read concurrently.
+     *
+     * All the registers are logged, as binary FFDC, on first run and
+     * when they differ from the last logged snapshot, otherwise only
+     * their digest is logged.
+     *
+     * @param[in,out] snapshot - clock data snapshot
+     */
+    void addClockRegData(ClockSnapshot& snapshot);
+
+    /**
+     * @brief Publish the latest clock data to the status file
+     *
+     * The status file is a small JSON file on tmpfs, replaced atomically
+     * after every sample, so monitoring can poll the processor and clock
+     * state without creating or parsing logs.
+     *
+     * @param[in] snapshot - clock data snapshot
      */
-    void addClockRegData(openpower::pel::FFDCData& clockDataLog);
+    void publishStatus(const ClockSnapshot& snapshot);
+
+    /**
+     * @brief Load the last logged clock registers from the snapshot file
+     */
+    void loadClockRegSnapshot();
+
+    /**
+     * @brief Save the last logged clock registers to the snapshot file
+     */
+    void saveClockRegSnapshot();
 
   private:
     /* The sdeventplus even loop to use */
     sdeventplus::Event _event;
 
-    /** @brief Timer used for LEDs lamp test period */
+    /** @brief Timer used for the periodic sampling */
     sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+
+    /** @brief Timer delaying the event triggered sampling */
+    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> triggerTimer;
+
+    /** @brief Reason of the pending event triggered sampling */
+    std::string triggerReason;
+
+    /** @brief Host state and inventory functional state matches */
+    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> matches;
+
+    /** @brief SIGUSR1 handler writing the history to the journal */
+    sdeventplus::source::Signal historySignal;
+
+    /** @brief Recent clock data snapshots, oldest first */
+    std::deque<ClockSnapshot> history;
+
+    /** @brief When the last clock data log was created */
+    std::optional<std::chrono::steady_clock::time_point> lastLogTime;
+
+    /** @brief Last logged clock registers, by clock device tree path */
+    std::map<std::string, std::vector<uint8_t>> clockRegSnapshot;
 };
 
 } // namespace openpower::phal::clock
@@ -16,10 +16,13 @@
 
 #include "extensions/phal/clock_logger.hpp"
 
+#include "util.hpp"
+
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdeventplus/source/event.hpp>
 
+#include <csignal>
 #include <cstdlib>
 
 PHOSPHOR_LOG2_USING;
@@ -30,7 +33,16 @@ int main()
     try
     {
         info("Clock daily logger started");
-        auto bus = sdbusplus::bus::new_default();
+
+        // SIGUSR1 writes the clock data history to the journal. It is
+        // handled through the event loop, block it before any thread is
+        // started so it is never delivered to one.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGUSR1);
+        sigprocmask(SIG_BLOCK, &signals, nullptr);
+
+        auto& bus = openpower::util::getBus();
         auto event = sdeventplus::Event::get_default();
         openpower::phal::clock::Manager manager(event);
         bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
@@ -34,6 +34,9 @@ void phal_init(enum ipl_mode mode)
         throw std::runtime_error("pdbg target initialization failed");
     }
 
+    // Cached FSI/PIB targets of a previous initialization are stale
+    invalidateTargetCache();
+
     if (libekb_init())
     {
         log<level::ERR>("libekb_init failed");
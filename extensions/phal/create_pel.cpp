@@ -2,25 +2,34 @@
 
 #include "attributes_info.H"
 
+#include "pel_queue.hpp"
+#include "pel_rate_limit.hpp"
 #include "util.hpp"
 
 #include <fcntl.h>
 #include <libekb.H>
 #include <libphal.H>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include <phosphor-logging/elog.hpp>
 #include <xyz/openbmc_project/Logging/Create/server.hpp>
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
+#include <array>
 #include <cerrno>
-#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <format>
+#include <functional>
 #include <map>
+#include <memory>
+#include <ostream>
+#include <span>
 #include <stdexcept>
+#include <streambuf>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -35,6 +44,60 @@ constexpr auto loggingObjectPath = "/xyz/openbmc_project/logging";
 constexpr auto loggingInterface = "xyz.openbmc_project.Logging.Create";
 constexpr auto opLoggingInterface = "org.open_power.Logging.PEL";
 
+/**
+ * @brief Report duplicates dropped by the rate limit in the PEL
+ *
+ * @param[in,out] additionalData - PEL additional data
+ * @param[in] suppressed - number of dropped duplicates
+ */
+static void addSuppressedCount(
+    std::map<std::string, std::string>& additionalData, uint32_t suppressed)
+{
+    if (suppressed > 0)
+    {
+        additionalData.emplace("SUPPRESSED_COUNT", std::to_string(suppressed));
+    }
+}
+
+/**
+ * @brief Create the FFDC files of binary FFDC sections
+ *
+ * A section which can't be written to its file is left out of the PEL,
+ * the failure is only traced.
+ *
+ * @param[in] sections - binary FFDC sections
+ *
+ * @return FFDC files, they must be kept open until the PEL is created
+ */
+static std::vector<std::unique_ptr<FFDCFile>>
+    createSectionFiles(const FFDCSections& sections)
+{
+    std::vector<std::unique_ptr<FFDCFile>> files;
+    for (const auto& section : sections)
+    {
+        if (section.empty())
+        {
+            continue;
+        }
+        try
+        {
+            auto data = section.data();
+            // explicit span, a byte vector also converts to json
+            files.push_back(std::make_unique<FFDCFile>(
+                std::span<const uint8_t>(data)));
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(std::format("Skipping FFDC section({}) due to "
+                                        "Exception({})",
+                                        static_cast<int>(section.type()),
+                                        e.what())
+                                .c_str());
+        }
+    }
+    return files;
+}
+
 /**
  * @brief get SBE special callout information
  *
@@ -79,11 +142,19 @@ static void getSBECallout(struct pdbg_target* procTarget,
 }
 
 void createErrorPEL(const std::string& event, const json& calloutData,
-                    const FFDCData& ffdcData, const Severity severity)
+                    const FFDCData& ffdcData, const Severity severity,
+                    const FFDCSections& sections)
 {
+    auto suppressed = checkRateLimit(event, severity, ffdcData);
+    if (!suppressed)
+    {
+        return;
+    }
+
     std::map<std::string, std::string> additionalData;
-    auto bus = sdbusplus::bus::new_default();
+    auto& bus = util::getBus();
     additionalData.emplace("_PID", std::to_string(getpid()));
+    addSuppressedCount(additionalData, *suppressed);
     for (auto& data : ffdcData)
     {
         additionalData.emplace(data);
@@ -104,6 +175,15 @@ void createErrorPEL(const std::string& event, const json& calloutData,
                             static_cast<uint8_t>(0xCA),
                             static_cast<uint8_t>(0x01), ffdcFile.getFileFD()));
 
+        auto sectionFiles = createSectionFiles(sections);
+        for (const auto& file : sectionFiles)
+        {
+            pelCalloutInfo.emplace_back(FFDCFormat::Custom,
+                                        FFDC_SECTION_SUBTYPE,
+                                        FFDC_SECTION_VERSION,
+                                        file->getFileFD());
+        }
+
         std::string service = util::getService(bus, loggingObjectPath,
                                                loggingInterface);
         auto method = bus.new_method_call(service.c_str(), loggingObjectPath,
@@ -134,14 +214,23 @@ void createErrorPEL(const std::string& event, const json& calloutData,
 uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
                            const FFDCData& ffdcData,
                            struct pdbg_target* procTarget,
-                           const Severity severity)
+                           const Severity severity,
+                           const FFDCSections& sections)
 {
     uint32_t plid = 0;
+
+    auto suppressed = checkRateLimit(event, severity, ffdcData);
+    if (!suppressed)
+    {
+        return plid;
+    }
+
     std::map<std::string, std::string> additionalData;
-    auto bus = sdbusplus::bus::new_default();
+    auto& bus = util::getBus();
 
     additionalData.emplace("_PID", std::to_string(getpid()));
     additionalData.emplace("SBE_ERR_MSG", sbeError.what());
+    addSuppressedCount(additionalData, *suppressed);
 
     for (auto& data : ffdcData)
     {
@@ -171,6 +260,13 @@ uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
                             static_cast<uint8_t>(0x01), sbeError.getFd()));
     }
 
+    auto sectionFiles = createSectionFiles(sections);
+    for (const auto& file : sectionFiles)
+    {
+        pelFFDCInfo.emplace_back(FFDCFormat::Custom, FFDC_SECTION_SUBTYPE,
+                                 FFDC_SECTION_VERSION, file->getFileFD());
+    }
+
     // Workaround : currently sbe_extract_rc hwp procedure based callout
     // handling is not available. openbmc issue #2917
     // As per discussion with RAS team adding additional callout for
@@ -239,13 +335,20 @@ uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
     return plid;
 }
 
-void createPEL(const std::string& event, const FFDCData& ffdcData,
-               const Severity severity)
+bool createPEL(const std::string& event, const FFDCData& ffdcData,
+               const Severity severity, const FFDCSections& sections)
 {
+    auto suppressed = checkRateLimit(event, severity, ffdcData);
+    if (!suppressed)
+    {
+        return false;
+    }
+
     std::map<std::string, std::string> additionalData;
-    auto bus = sdbusplus::bus::new_default();
+    auto& bus = util::getBus();
 
     additionalData.emplace("_PID", std::to_string(getpid()));
+    addSuppressedCount(additionalData, *suppressed);
     for (auto& data : ffdcData)
     {
         additionalData.emplace(data);
@@ -253,14 +356,32 @@ void createPEL(const std::string& event, const FFDCData& ffdcData,
 
     try
     {
+        std::vector<std::tuple<FFDCFormat, uint8_t, uint8_t,
+                               sdbusplus::message::unix_fd>>
+            pelFFDCInfo;
+        auto sectionFiles = createSectionFiles(sections);
+        for (const auto& file : sectionFiles)
+        {
+            pelFFDCInfo.emplace_back(FFDCFormat::Custom, FFDC_SECTION_SUBTYPE,
+                                     FFDC_SECTION_VERSION, file->getFileFD());
+        }
+
         std::string service = util::getService(bus, loggingObjectPath,
                                                loggingInterface);
-        auto method = bus.new_method_call(service.c_str(), loggingObjectPath,
-                                          loggingInterface, "Create");
+        auto method = bus.new_method_call(
+            service.c_str(), loggingObjectPath, loggingInterface,
+            pelFFDCInfo.empty() ? "Create" : "CreateWithFFDCFiles");
         auto level =
             sdbusplus::xyz::openbmc_project::Logging::server::convertForMessage(
                 severity);
-        method.append(event, level, additionalData);
+        if (pelFFDCInfo.empty())
+        {
+            method.append(event, level, additionalData);
+        }
+        else
+        {
+            method.append(event, level, additionalData, pelFFDCInfo);
+        }
         auto resp = bus.call(method);
     }
     catch (const sdbusplus::exception_t& e)
@@ -282,13 +403,200 @@ void createPEL(const std::string& event, const FFDCData& ffdcData,
                 .c_str());
         throw e;
     }
+    return true;
 }
 
-FFDCFile::FFDCFile(const json& pHALCalloutData) :
-    calloutData(pHALCalloutData.dump()),
-    calloutFile("/tmp/phalPELCalloutsJson.XXXXXX"), fileFD(-1)
+/**
+ * @brief Build the PEL request for the submit queue
+ *
+ * The coalesce key covers everything which ends up in the PEL, so only
+ * identical requests are folded. The callout data and the FFDC sections
+ * are hashed into the key instead of being copied.
+ *
+ * @param[in] event - the event type
+ * @param[in] ffdcData - failure data to append to PEL
+ * @param[in] severity - severity of the log
+ * @param[in] calloutData - callout data, null if none
+ * @param[in] suppressed - number of dropped duplicates to report
+ * @param[in] sections - binary FFDC sections to append to PEL
+ *
+ * @return PEL request
+ */
+static PELRequest buildRequest(const std::string& event,
+                               const FFDCData& ffdcData,
+                               const Severity severity, const json* calloutData,
+                               uint32_t suppressed,
+                               const FFDCSections& sections)
 {
-    prepareFFDCFile();
+    PELRequest request;
+    request.event = event;
+    request.severity = severity;
+    request.additionalData.emplace("_PID", std::to_string(getpid()));
+    addSuppressedCount(request.additionalData, suppressed);
+    for (auto& data : ffdcData)
+    {
+        request.additionalData.emplace(data);
+    }
+
+    request.coalesceKey = std::format(
+        "{}|{}|", event,
+        sdbusplus::xyz::openbmc_project::Logging::server::convertForMessage(
+            severity));
+    for (const auto& [key, value] : request.additionalData)
+    {
+        request.coalesceKey += std::format("{}={}|", key, value);
+    }
+    if (calloutData != nullptr)
+    {
+        // Hashed from the json values, without serializing them
+        request.coalesceKey += std::format("{:x}",
+                                           std::hash<json>{}(*calloutData));
+    }
+
+    // The queued request holds its own fds, the files themselves are not
+    // needed once the request is built.
+    auto sectionFiles = createSectionFiles(sections);
+    for (const auto& file : sectionFiles)
+    {
+        request.ffdcFiles.emplace_back(FFDCFormat::Custom,
+                                       FFDC_SECTION_SUBTYPE,
+                                       FFDC_SECTION_VERSION,
+                                       file->getFileFD());
+    }
+    for (const auto& section : sections)
+    {
+        auto data = section.data();
+        request.coalesceKey += std::format(
+            "|{}:{:x}", data.size(),
+            std::hash<std::string_view>{}(std::string_view(
+                reinterpret_cast<const char*>(data.data()), data.size())));
+    }
+    return request;
+}
+
+void queueErrorPEL(const std::string& event, const json& calloutData,
+                   const FFDCData& ffdcData, const Severity severity,
+                   const FFDCSections& sections)
+{
+    auto suppressed = checkRateLimit(event, severity, ffdcData);
+    if (!suppressed)
+    {
+        return;
+    }
+
+    auto request = buildRequest(event, ffdcData, severity, &calloutData,
+                                *suppressed, sections);
+
+    // The queued request holds its own fd, the file itself is not needed
+    // once this function returns.
+    FFDCFile ffdcFile(calloutData);
+    request.ffdcFiles.emplace_back(
+        sdbusplus::xyz::openbmc_project::Logging::server::Create::FFDCFormat::
+            JSON,
+        static_cast<uint8_t>(0xCA), static_cast<uint8_t>(0x01),
+        ffdcFile.getFileFD());
+
+    SubmitQueue::get().submit(std::move(request));
+}
+
+void queuePEL(const std::string& event, const FFDCData& ffdcData,
+              const Severity severity, const FFDCSections& sections)
+{
+    auto suppressed = checkRateLimit(event, severity, ffdcData);
+    if (!suppressed)
+    {
+        return;
+    }
+
+    SubmitQueue::get().submit(
+        buildRequest(event, ffdcData, severity, nullptr, *suppressed,
+                     sections));
+}
+
+namespace
+{
+
+/**
+ * @class FDStreamBuf
+ * @brief Output stream buffer writing to a file descriptor
+ *
+ * Used to serialize json straight into the ffdc file through a small
+ * buffer. Write failures are recorded and reported through failed().
+ */
+class FDStreamBuf : public std::streambuf
+{
+  public:
+    explicit FDStreamBuf(int fd) : fd(fd)
+    {
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    /**
+     * @brief Error number of the first failed write, 0 if none
+     */
+    int failed() const
+    {
+        return error;
+    }
+
+  protected:
+    int_type overflow(int_type ch) override
+    {
+        if (flush() != 0)
+        {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int sync() override
+    {
+        return flush();
+    }
+
+  private:
+    int flush()
+    {
+        const char* data = pbase();
+        size_t size = pptr() - pbase();
+        while ((size > 0) && (error == 0))
+        {
+            ssize_t rc = write(fd, data, size);
+            if (rc == -1)
+            {
+                if (errno != EINTR)
+                {
+                    error = errno;
+                }
+                continue;
+            }
+            data += rc;
+            size -= rc;
+        }
+        setp(buffer.data(), buffer.data() + buffer.size());
+        return (error == 0) ? 0 : -1;
+    }
+
+    int fd;
+    int error = 0;
+    std::array<char, 4096> buffer;
+};
+
+} // namespace
+
+FFDCFile::FFDCFile(const json& pHALCalloutData) : fileFD(-1)
+{
+    prepareFFDCFile(pHALCalloutData);
+}
+
+FFDCFile::FFDCFile(std::span<const uint8_t> data) : fileFD(-1)
+{
+    prepareFFDCFile(data);
 }
 
 FFDCFile::~FFDCFile()
@@ -301,45 +609,99 @@ int FFDCFile::getFileFD() const
     return fileFD;
 }
 
-void FFDCFile::prepareFFDCFile()
+void FFDCFile::prepareFFDCFile(const json& calloutData)
 {
     createCalloutFile();
-    writeCalloutData();
-    setCalloutFileSeekPos();
+    try
+    {
+        writeCalloutData(calloutData);
+        sealCalloutFile();
+        setCalloutFileSeekPos();
+    }
+    catch (...)
+    {
+        // destructor is not called for a failed constructor
+        removeCalloutFile();
+        throw;
+    }
+}
+
+void FFDCFile::prepareFFDCFile(std::span<const uint8_t> data)
+{
+    createCalloutFile();
+    try
+    {
+        writeBinaryData(data);
+        sealCalloutFile();
+        setCalloutFileSeekPos();
+    }
+    catch (...)
+    {
+        // destructor is not called for a failed constructor
+        removeCalloutFile();
+        throw;
+    }
 }
 
 void FFDCFile::createCalloutFile()
 {
-    fileFD = mkostemp(const_cast<char*>(calloutFile.c_str()), O_RDWR);
+    fileFD = memfd_create("phalPELCalloutsJson",
+                          MFD_CLOEXEC | MFD_ALLOW_SEALING);
 
     if (fileFD == -1)
     {
         log<level::ERR>(std::format("Failed to create phalPELCallouts "
-                                    "file({}), errorno({}) and errormsg({})",
-                                    calloutFile, errno, strerror(errno))
+                                    "file, errorno({}) and errormsg({})",
+                                    errno, strerror(errno))
                             .c_str());
         throw std::runtime_error("Failed to create phalPELCallouts file");
     }
 }
 
-void FFDCFile::writeCalloutData()
+void FFDCFile::writeCalloutData(const json& calloutData)
 {
-    ssize_t rc = write(fileFD, calloutData.c_str(), calloutData.size());
+    FDStreamBuf buf(fileFD);
+    std::ostream out(&buf);
+    out << calloutData;
+    out.flush();
 
-    if (rc == -1)
+    if (buf.failed() != 0)
     {
         log<level::ERR>(std::format("Failed to write phaPELCallout info "
-                                    "in file({}), errorno({}), errormsg({})",
-                                    calloutFile, errno, strerror(errno))
+                                    "in file, errorno({}), errormsg({})",
+                                    buf.failed(), strerror(buf.failed()))
                             .c_str());
         throw std::runtime_error("Failed to write phalPELCallouts info");
     }
-    else if (rc != static_cast<ssize_t>(calloutData.size()))
+}
+
+void FFDCFile::writeBinaryData(std::span<const uint8_t> data)
+{
+    FDStreamBuf buf(fileFD);
+    std::ostream out(&buf);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    out.flush();
+
+    if (buf.failed() != 0)
     {
-        log<level::WARNING>(std::format("Could not write all phal callout "
-                                        "info in file({}), written byte({}) "
-                                        "and total byte({})",
-                                        calloutFile, rc, calloutData.size())
+        log<level::ERR>(std::format("Failed to write FFDC section data "
+                                    "in file, errorno({}), errormsg({})",
+                                    buf.failed(), strerror(buf.failed()))
+                            .c_str());
+        throw std::runtime_error("Failed to write FFDC section data");
+    }
+}
+
+void FFDCFile::sealCalloutFile()
+{
+    // Sealing only guards the data against later modification, the file
+    // is still usable without it.
+    if (fcntl(fileFD, F_ADD_SEALS,
+              F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1)
+    {
+        log<level::WARNING>(std::format("Failed to seal phalPELCallouts "
+                                        "file, errorno({}) and errormsg({})",
+                                        errno, strerror(errno))
                                 .c_str());
     }
 }
@@ -351,9 +713,9 @@ void FFDCFile::setCalloutFileSeekPos()
     if (rc == -1)
     {
         log<level::ERR>(std::format("Failed to set SEEK_SET for "
-                                    "phalPELCallouts in file({}), errorno({}) "
+                                    "phalPELCallouts file, errorno({}) "
                                     "and errormsg({})",
-                                    calloutFile, errno, strerror(errno))
+                                    errno, strerror(errno))
                             .c_str());
         throw std::runtime_error(
             "Failed to set SEEK_SET for phalPELCallouts file");
@@ -362,8 +724,11 @@ void FFDCFile::setCalloutFileSeekPos()
 
 void FFDCFile::removeCalloutFile()
 {
-    close(fileFD);
-    std::remove(calloutFile.c_str());
+    if (fileFD != -1)
+    {
+        close(fileFD);
+        fileFD = -1;
+    }
 }
 
 } // namespace pel
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "extensions/phal/ffdc_section.hpp"
 #include "xyz/openbmc_project/Logging/Entry/server.hpp"
 
 #include <phal_exception.H>
 
 #include <nlohmann/json.hpp>
 
+#include <span>
 #include <string>
 #include <vector>
 
@@ -26,14 +28,21 @@ using Severity = sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level;
 /**
  * @brief Create PEL with additional parameters and callout
  *
+ * All the create and queue functions drop PELs which exceed the rate
+ * limit policy of the event, see pel_rate_limit.hpp. Bulk data is passed
+ * as binary FFDC sections, see ffdc_section.hpp, and only summary keys
+ * in the failure data.
+ *
  * @param[in] event - the event type
  * @param[in] calloutData - callout data to append to PEL
  * @param[in] ffdcData - failure data to append to PEL
  * @param[in] severity - severity of the log default to Informational
+ * @param[in] sections - binary FFDC sections to append to PEL
  */
 void createErrorPEL(const std::string& event, const json& calloutData = {},
                     const FFDCData& ffdcData = {},
-                    const Severity severity = Severity::Informational);
+                    const Severity severity = Severity::Informational,
+                    const FFDCSections& sections = {});
 
 /**
  * @brief Create SBE boot error PEL and return id
@@ -43,12 +52,16 @@ void createErrorPEL(const std::string& event, const json& calloutData = {},
  * @param[in] ffdcData - failure data to append to PEL
  * @param[in] procTarget - pdbg processor target
  * @param[in] severity - severity of the log
- * @return Platform log id
+ * @param[in] sections - binary FFDC sections to append to PEL
+ * @return Platform log id, 0 if the PEL was dropped by the rate limit.
+ *         Callers must check for 0 before referencing the PEL, e.g. in
+ *         a dump request, the dropped duplicate has no log to refer to.
  */
 uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
                            const FFDCData& ffdcData,
                            struct pdbg_target* procTarget,
-                           const Severity severity = Severity::Error);
+                           const Severity severity = Severity::Error,
+                           const FFDCSections& sections = {});
 
 /**
  * @brief Create a PEL for the specified event type and additional data
@@ -56,13 +69,55 @@ uint32_t createSbeErrorPEL(const std::string& event, const sbeError_t& sbeError,
  *  @param[in]  event - the event type
  *  @param[in] ffdcData - failure data to append to PEL
  *  @param[in] severity - severity of the log
+ *  @param[in] sections - binary FFDC sections to append to PEL
+ *
+ *  @return true if the PEL was created, false if it was dropped by the
+ *          rate limit
+ */
+bool createPEL(const std::string& event, const FFDCData& ffdcData = {},
+               const Severity severity = Severity::Error,
+               const FFDCSections& sections = {});
+
+/**
+ * @brief Queue PEL with additional parameters and callout for creation
+ *
+ * Same as createErrorPEL, but the request is handed over to the PEL
+ * submit queue and the call returns without waiting for the logging
+ * service. Submit failures are only traced.
+ *
+ * @param[in] event - the event type
+ * @param[in] calloutData - callout data to append to PEL
+ * @param[in] ffdcData - failure data to append to PEL
+ * @param[in] severity - severity of the log default to Informational
+ * @param[in] sections - binary FFDC sections to append to PEL
  */
-void createPEL(const std::string& event, const FFDCData& ffdcData = {},
-               const Severity severity = Severity::Error);
+void queueErrorPEL(const std::string& event, const json& calloutData = {},
+                   const FFDCData& ffdcData = {},
+                   const Severity severity = Severity::Informational,
+                   const FFDCSections& sections = {});
+
+/**
+ * @brief Queue PEL for the specified event type and additional data
+ *
+ * Same as createPEL, but the call returns without waiting for the
+ * logging service.
+ *
+ * @param[in] event - the event type
+ * @param[in] ffdcData - failure data to append to PEL
+ * @param[in] severity - severity of the log
+ * @param[in] sections - binary FFDC sections to append to PEL
+ */
+void queuePEL(const std::string& event, const FFDCData& ffdcData = {},
+              const Severity severity = Severity::Error,
+              const FFDCSections& sections = {});
 
 /**
  * @class FFDCFile
  * @brief This class is used to create ffdc data file and to get fd
+ *
+ * The file is an anonymous memory file (memfd), so nothing is left
+ * behind in the filesystem, and it is sealed against modification
+ * once the callout data or the binary FFDC section is written.
  */
 class FFDCFile
 {
@@ -80,7 +135,13 @@ class FFDCFile
     explicit FFDCFile(const json& pHALCalloutData);
 
     /**
-     * Used to remove created ffdc file.
+     * Used to pass binary data, a FFDC section, to create unique ffdc
+     * file with it.
+     */
+    explicit FFDCFile(std::span<const uint8_t> data);
+
+    /**
+     * Used to close created ffdc file.
      */
     ~FFDCFile();
 
@@ -93,41 +154,62 @@ class FFDCFile
 
   private:
     /**
-     * Used to store callout ffdc data from passed json object.
+     * Used to store created ffdc file descriptor id.
      */
-    std::string calloutData;
+    int fileFD;
 
     /**
-     * Used to store unique ffdc file name.
+     * Used to create ffdc file to pass PEL api for creating
+     * pel records.
+     *
+     * @param[in] calloutData - callout data to write
+     *
+     * @return NULL
      */
-    std::string calloutFile;
+    void prepareFFDCFile(const json& calloutData);
 
     /**
-     * Used to store created ffdc file descriptor id.
+     * Used to create ffdc file with binary data to pass PEL api for
+     * creating pel records.
+     *
+     * @param[in] data - binary data to write
+     *
+     * @return NULL
      */
-    int fileFD;
+    void prepareFFDCFile(std::span<const uint8_t> data);
 
     /**
-     * Used to create ffdc file to pass PEL api for creating
-     * pel records.
+     * Create anonymous ffdc memory file.
      *
      * @return NULL
      */
-    void prepareFFDCFile();
+    void createCalloutFile();
 
     /**
-     * Create unique ffdc file.
+     * Used to serialize json object directly into created file,
+     * without an intermediate string copy.
+     *
+     * @param[in] calloutData - callout data to write
      *
      * @return NULL
      */
-    void createCalloutFile();
+    void writeCalloutData(const json& calloutData);
+
+    /**
+     * Used to write binary data into created file.
+     *
+     * @param[in] data - binary data to write
+     *
+     * @return NULL
+     */
+    void writeBinaryData(std::span<const uint8_t> data);
 
     /**
-     * Used write json object value into created file.
+     * Used to seal created file against further modification.
      *
      * @return NULL
      */
-    void writeCalloutData();
+    void sealCalloutFile();
 
     /**
      * Used set ffdc file seek position begining to consume by PEL
@@ -137,7 +219,7 @@ class FFDCFile
     void setCalloutFileSeekPos();
 
     /**
-     * Used to remove created ffdc file.
+     * Used to close created ffdc file.
      *
      * @return NULL
      */
@@ -1,8 +1,11 @@
 #include "fw_update_watch.hpp"
 
+#include "util.hpp"
+
 #include <phosphor-logging/elog-errors.hpp>
 #include <sdeventplus/event.hpp>
 
+#include <csignal>
 #include <format>
 
 int main()
@@ -11,12 +14,21 @@ int main()
 
     try
     {
-        auto bus = sdbusplus::bus::new_default();
+        auto& bus = openpower::util::getBus();
 
         auto event = sdeventplus::Event::get_default();
 
+        // SIGCHLD must be blocked to watch the export child process
+        // through the event loop.
+        sigset_t ss;
+        if ((sigemptyset(&ss) < 0) || (sigaddset(&ss, SIGCHLD) < 0) ||
+            (sigprocmask(SIG_BLOCK, &ss, nullptr) < 0))
+        {
+            throw std::runtime_error("Failed to block SIGCHLD");
+        }
+
         // create watch for interface added in software update.
-        openpower::phal::fwupdate::Watch eWatch(bus);
+        openpower::phal::fwupdate::Watch eWatch(bus, event);
 
         bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
 
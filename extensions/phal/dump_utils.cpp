@@ -2,103 +2,371 @@
 
 #include "util.hpp"
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/exception.hpp>
 #include <sdbusplus/server.hpp>
+#include <sdeventplus/source/io.hpp>
 
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <format>
+#include <optional>
+#include <stdexcept>
+#include <variant>
 
 namespace openpower::phal::dump
 {
 
 using namespace phosphor::logging;
 
+using PropertyMap = std::map<std::string, std::variant<std::string, uint64_t>>;
+
+constexpr auto progressInterface = "xyz.openbmc_project.Common.Progress";
+
+/** Monitor of this process, never destroyed, see DumpMonitor::stop() */
+static DumpMonitor* monitor = nullptr;
+static std::mutex monitorLock;
+
 /**
- *  Callback for dump request properties change signal monitor
+ * Get the dump outcome from Progress properties
  *
- * @param[in] msg         Dbus message from the dbus match infrastructure
- * @param[in] path        The object path we are monitoring
- * @param[out] inProgress Used to break out of our dbus wait loop
- * @reutn Always non-zero indicating no error, no cascading callbacks
+ * @param[in] properties Changed or current Progress properties
+ * @return dump outcome, empty while the dump is in progress
  */
-uint32_t dumpStatusChanged(sdbusplus::message_t& msg, const std::string& path,
-                           bool& inProgress)
+static std::optional<DumpStatus> getDumpStatus(const PropertyMap& properties)
 {
-    // reply (msg) will be a property change message
-    std::string interface;
-    std::map<std::string, std::variant<std::string, uint8_t>> property;
-    msg.read(interface, property);
-
     // looking for property Status changes
-    std::string propertyType = "Status";
-    auto dumpStatus = property.find(propertyType);
+    auto dumpStatus = properties.find("Status");
+    if (dumpStatus == properties.end())
+    {
+        return std::nullopt;
+    }
+
+    const std::string* status =
+        std::get_if<std::string>(&(dumpStatus->second));
+    if ((nullptr == status) || ("xyz.openbmc_project.Common.Progress."
+                                "OperationStatus.InProgress" == *status))
+    {
+        return std::nullopt;
+    }
+
+    if ("xyz.openbmc_project.Common.Progress.OperationStatus.Completed" ==
+        *status)
+    {
+        return DumpStatus::Completed;
+    }
+    log<level::ERR>(std::format("Dump status({})", *status).c_str());
+    return DumpStatus::Failed;
+}
+
+DumpMonitor& DumpMonitor::get()
+{
+    std::lock_guard<std::mutex> guard(monitorLock);
+
+    // A forked child has none of the parent's threads
+    if ((monitor == nullptr) || (monitor->owner != getpid()))
+    {
+        monitor = new DumpMonitor();
+    }
+    return *monitor;
+}
 
-    if (dumpStatus != property.end())
+DumpMonitor::DumpMonitor() :
+    owner(getpid()), wakeFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+{
+    if (wakeFd == -1)
     {
-        const std::string* status =
-            std::get_if<std::string>(&(dumpStatus->second));
+        log<level::ERR>(std::format("Failed to create dump monitor eventfd, "
+                                    "errorno({}) and errormsg({})",
+                                    errno, strerror(errno))
+                            .c_str());
+        throw std::runtime_error("Failed to create dump monitor eventfd");
+    }
 
-        if ((nullptr != status) && ("xyz.openbmc_project.Common.Progress."
-                                    "OperationStatus.InProgress" != *status))
+    worker = std::thread(&DumpMonitor::run, this);
+    std::atexit(&DumpMonitor::stop);
+}
+
+void DumpMonitor::stop()
+{
+    DumpMonitor* current = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(monitorLock);
+        current = monitor;
+    }
+
+    // atexit handlers are inherited by forked children, which don't have
+    // the worker thread.
+    if ((current == nullptr) || (current->owner != getpid()))
+    {
+        return;
+    }
+
+    current->wait();
+    {
+        std::lock_guard<std::mutex> guard(current->lock);
+        current->stopping = true;
+    }
+    current->wakeUp();
+
+    if (current->worker.joinable())
+    {
+        current->worker.join();
+    }
+}
+
+void DumpMonitor::add(const std::string& service, const std::string& path,
+                      uint32_t timeout, DumpCallback callback)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (stopping)
         {
-            // dump is done, trace some info and change in progress flag
-            log<level::INFO>(std::format("Dump status({}) : path={}",
-                                         status->c_str(), path.c_str())
-                                 .c_str());
-            inProgress = false;
+            log<level::ERR>(
+                std::format("Dump monitor stopped, not monitoring dump({})",
+                            path)
+                    .c_str());
+            return;
         }
+        requests.push_back({service, path, timeout, std::move(callback)});
+        inFlight++;
     }
+    wakeUp();
+}
 
-    return 1; // non-negative return code for successful callback
+void DumpMonitor::wait()
+{
+    if (owner != getpid())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    if (inFlight != 0)
+    {
+        log<level::INFO>(
+            std::format("Waiting for ({}) dumps in progress", inFlight)
+                .c_str());
+    }
+    finished.wait(guard, [this] { return inFlight == 0; });
 }
 
-/**
- * Register a callback for dump progress status changes
- *
- * @param[in] path The object path of the dump to monitor
- * @param timeout - timeout - timeout interval in seconds
- */
-void monitorDump(const std::string& path, const uint32_t timeout)
+void DumpMonitor::wakeUp()
+{
+    uint64_t count = 1;
+    if (write(wakeFd, &count, sizeof(count)) == -1)
+    {
+        log<level::ERR>(std::format("Failed to wake up dump monitor, "
+                                    "errorno({}) and errormsg({})",
+                                    errno, strerror(errno))
+                            .c_str());
+    }
+}
+
+void DumpMonitor::run()
+{
+    try
+    {
+        // sd-bus connections are not thread safe, so the worker has its own
+        auto bus = sdbusplus::bus::new_system();
+        auto event = sdeventplus::Event::get_new();
+        bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
+
+        sdeventplus::source::IO wake(
+            event, wakeFd, EPOLLIN,
+            [this, &bus](sdeventplus::source::IO& io, int fd, uint32_t) {
+            uint64_t count;
+            if (read(fd, &count, sizeof(count)) == -1)
+            {
+                return;
+            }
+            update(bus, io.get_event());
+        });
+
+        // Requests added before the loop started
+        update(bus, event);
+        event.loop();
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            std::format("Dump monitor failed, EXCEPTION({})", e.what())
+                .c_str());
+
+        // Nothing is going to finish the dumps in flight anymore
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+        requests.clear();
+        inFlight = 0;
+        finished.notify_all();
+    }
+}
+
+void DumpMonitor::update(sdbusplus::bus_t& bus,
+                         const sdeventplus::Event& event)
+{
+    std::deque<Request> pending;
+    bool stop = false;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending.swap(requests);
+        stop = stopping;
+    }
+
+    // Finished dumps are dropped here, not from their own match or timer
+    // callback.
+    std::erase_if(dumps, [](const auto& dump) { return dump.second.done; });
+
+    for (auto& request : pending)
+    {
+        watch(bus, event, std::move(request));
+    }
+
+    if (stop)
+    {
+        event.exit(0);
+    }
+}
+
+void DumpMonitor::watch(sdbusplus::bus_t& bus, const sdeventplus::Event& event,
+                        Request&& request)
 {
-    bool inProgress = true; // callback will update this
+    const auto path = request.path;
+    auto [it, added] = dumps.try_emplace(path);
+    if (!added)
+    {
+        // Dump object paths are not reused while a dump is in flight
+        log<level::ERR>(
+            std::format("Dump({}) is already monitored", path).c_str());
+        std::lock_guard<std::mutex> guard(lock);
+        inFlight--;
+        finished.notify_all();
+        return;
+    }
+
+    auto& dump = it->second;
+    dump.callback = std::move(request.callback);
 
     // setup the signal match rules and callback
-    std::string matchInterface = "xyz.openbmc_project.Common.Progress";
-    auto bus = sdbusplus::bus::new_system();
-
-    std::unique_ptr<sdbusplus::bus::match_t> match =
-        std::make_unique<sdbusplus::bus::match_t>(
-            bus,
-            sdbusplus::bus::match::rules::propertiesChanged(
-                path.c_str(), matchInterface.c_str()),
-            [&](auto& msg) {
-        return dumpStatusChanged(msg, path, inProgress);
+    dump.match = std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        sdbusplus::bus::match::rules::propertiesChanged(path,
+                                                        progressInterface),
+        [this, path](sdbusplus::message_t& msg) {
+        try
+        {
+            // reply (msg) will be a property change message
+            std::string interface;
+            PropertyMap properties;
+            msg.read(interface, properties);
+
+            if (auto status = getDumpStatus(properties))
+            {
+                finish(path, *status);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(std::format("Failed to read dump({}) status "
+                                        "change, EXCEPTION({})",
+                                        path, e.what())
+                                .c_str());
+        }
     });
 
-    // wait for dump status to be completed (complete == true)
-    // or until timeout interval
-    log<level::INFO>("dump requested (waiting)");
-    bool timedOut = false;
-    uint32_t secondsCount = 0;
-    while ((true == inProgress) && !timedOut)
+    dump.timer = std::make_unique<Timer>(
+        event, [this, path](Timer&) { finish(path, DumpStatus::TimedOut); });
+    dump.timer->restartOnce(std::chrono::seconds(request.timeout));
+
+    log<level::INFO>(std::format("Monitoring dump({})", path).c_str());
+
+    // The dump may have finished before the match was added
+    try
     {
-        bus.wait(std::chrono::seconds(1));
-        bus.process_discard();
+        auto method = bus.new_method_call(request.service.c_str(),
+                                          path.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "GetAll");
+        method.append(progressInterface);
+        auto reply = bus.call(method);
 
-        if (++secondsCount == timeout)
+        PropertyMap properties;
+        reply.read(properties);
+        if (auto status = getDumpStatus(properties))
         {
-            timedOut = true;
+            finish(path, *status);
         }
     }
-    if (timedOut)
+    catch (const std::exception& e)
     {
-        log<level::ERR>("Dump progress status did not change to "
-                        "complete within the timeout interval, exiting...");
+        log<level::ERR>(std::format("Failed to get dump({}) status, "
+                                    "EXCEPTION({})",
+                                    path, e.what())
+                            .c_str());
     }
 }
 
-void requestDump(const DumpParameters& dumpParameters)
+void DumpMonitor::finish(const std::string& path, DumpStatus status)
+{
+    auto it = dumps.find(path);
+    if ((it == dumps.end()) || it->second.done)
+    {
+        return;
+    }
+
+    auto& dump = it->second;
+    dump.done = true;
+
+    if (status == DumpStatus::TimedOut)
+    {
+        log<level::ERR>(std::format("Dump({}) progress status did not change "
+                                    "to complete within the timeout interval",
+                                    path)
+                            .c_str());
+    }
+    else
+    {
+        // dump is done, trace some info
+        log<level::INFO>(std::format("Dump({}) done, status({})", path,
+                                     status == DumpStatus::Completed
+                                         ? "Completed"
+                                         : "Failed")
+                             .c_str());
+    }
+
+    if (dump.callback)
+    {
+        try
+        {
+            dump.callback(path, status);
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(std::format("Dump({}) callback failed, "
+                                        "EXCEPTION({})",
+                                        path, e.what())
+                                .c_str());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        inFlight--;
+    }
+    finished.notify_all();
+
+    // Drop the dump outside of this callback
+    wakeUp();
+}
+
+void requestDump(const DumpParameters& dumpParameters, DumpCallback callback)
 {
     log<level::INFO>(std::format("Requesting Dump PEL({}) Index({})",
                                  dumpParameters.logId, dumpParameters.unitId)
@@ -110,7 +378,7 @@ void requestDump(const DumpParameters& dumpParameters)
 
     sdbusplus::message_t method;
 
-    auto bus = sdbusplus::bus::new_default();
+    auto& bus = util::getBus();
 
     try
     {
@@ -138,7 +406,8 @@ void requestDump(const DumpParameters& dumpParameters)
         response.read(reply);
 
         // monitor dump progress
-        monitorDump(reply, dumpParameters.timeout);
+        DumpMonitor::get().add(service, reply, dumpParameters.timeout,
+                               std::move(callback));
     }
     catch (const sdbusplus::exception_t& e)
     {
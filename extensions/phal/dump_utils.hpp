@@ -1,7 +1,22 @@
-#include <cstdint>
-
 #pragma once
 
+#include <sys/types.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/utility/timer.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
 namespace openpower::phal::dump
 {
 
@@ -22,14 +37,171 @@ struct DumpParameters
     DumpType dumpType;
 };
 
+/** @brief Outcome of a requested dump */
+enum class DumpStatus
+{
+    Completed,
+    Failed,
+    TimedOut
+};
+
+/**
+ * @brief Dump completion callback
+ *
+ * Called on the dump monitor thread with the dump object path and the
+ * outcome of the dump.
+ */
+using DumpCallback = std::function<void(const std::string&, DumpStatus)>;
+
 /**
  * Request a dump from the dump manager
  *
- * Request a dump from the dump manager and register a monitor for observing
- * the dump progress.
+ * Request a dump from the dump manager and hand it over to the dump
+ * monitor for observing the dump progress. The call returns once the
+ * dump manager accepted the request, without waiting for the dump.
  *
  * @param dumpParameters Parameters for the dump request
+ * @param callback Optional callback reporting the outcome of the dump
+ */
+void requestDump(const DumpParameters& dumpParameters,
+                 DumpCallback callback = {});
+
+/**
+ * @class DumpMonitor
+ * @brief Observe the progress of requested dumps from a worker thread
+ *
+ * Each dump is watched through the Progress Status PropertiesChanged
+ * signal of its object and a timeout timer on the monitor's sd-event
+ * loop, so any number of dumps can be in flight without blocking the
+ * requester.
+ *
+ * The process waits for the dumps in flight, up to their timeout, before
+ * it exits, so the procedure does not complete while the dump manager
+ * still collects a dump. wait() can be used to wait for them explicitly.
+ * A forked child gets its own monitor on first use.
  */
-void requestDump(const DumpParameters& dumpParameters);
+class DumpMonitor
+{
+  public:
+    DumpMonitor(const DumpMonitor&) = delete;
+    DumpMonitor& operator=(const DumpMonitor&) = delete;
+    DumpMonitor(DumpMonitor&&) = delete;
+    DumpMonitor& operator=(DumpMonitor&&) = delete;
+
+    /**
+     * @brief Get the monitor of this process
+     */
+    static DumpMonitor& get();
+
+    /**
+     * @brief Start monitoring a dump
+     *
+     * @param[in] service - dump manager service
+     * @param[in] path - object path of the dump
+     * @param[in] timeout - timeout interval in seconds
+     * @param[in] callback - completion callback, may be empty
+     */
+    void add(const std::string& service, const std::string& path,
+             uint32_t timeout, DumpCallback callback);
+
+    /**
+     * @brief Wait until all the dumps in flight are done or timed out
+     */
+    void wait();
+
+  private:
+    using Timer =
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>;
+
+    /** @brief Dump handed over by add() to the worker */
+    struct Request
+    {
+        std::string service;
+        std::string path;
+        uint32_t timeout;
+        DumpCallback callback;
+    };
+
+    /** @brief Dump watched by the worker */
+    struct Dump
+    {
+        DumpCallback callback;
+        std::unique_ptr<sdbusplus::bus::match_t> match;
+        std::unique_ptr<Timer> timer;
+        bool done = false;
+    };
+
+    DumpMonitor();
+
+    /**
+     * @brief Wait for the dumps in flight and stop the worker thread
+     *
+     * Registered with atexit() by the owner process.
+     */
+    static void stop();
+
+    /**
+     * @brief Worker thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Wake up the worker to handle requests and finished dumps
+     */
+    void wakeUp();
+
+    /**
+     * @brief Start watching the new requests and drop the finished dumps
+     *
+     * Runs on the worker, outside of any dump callback.
+     *
+     * @param[in] bus - worker D-Bus connection
+     * @param[in] event - worker event loop
+     */
+    void update(sdbusplus::bus_t& bus, const sdeventplus::Event& event);
+
+    /**
+     * @brief Start watching a dump
+     *
+     * @param[in] bus - worker D-Bus connection
+     * @param[in] event - worker event loop
+     * @param[in] request - dump to watch
+     */
+    void watch(sdbusplus::bus_t& bus, const sdeventplus::Event& event,
+               Request&& request);
+
+    /**
+     * @brief Report the outcome of a dump, the first one wins
+     *
+     * @param[in] path - object path of the dump
+     * @param[in] status - outcome of the dump
+     */
+    void finish(const std::string& path, DumpStatus status);
+
+    /** Requests not picked up by the worker yet */
+    std::deque<Request> requests;
+
+    /** Dumps requested and not finished, the requests included */
+    size_t inFlight = 0;
+
+    /** Set to stop the worker */
+    bool stopping = false;
+
+    /** Dumps watched by the worker, only used on the worker thread */
+    std::map<std::string, Dump> dumps;
+
+    /** Process which owns the worker thread */
+    pid_t owner;
+
+    /** eventfd waking up the worker event loop */
+    int wakeFd;
+
+    std::mutex lock;
+
+    /** Signalled when a dump finished */
+    std::condition_variable finished;
+
+    std::thread worker;
+};
 
 } // namespace openpower::phal::dump
@@ -0,0 +1,46 @@
+#include "error_context.hpp"
+
+namespace openpower
+{
+namespace pel
+{
+
+/** Context installed on this thread, null for the process context */
+static thread_local ErrorContext* active = nullptr;
+
+ErrorContext& ErrorContext::current()
+{
+    if (active != nullptr)
+    {
+        return *active;
+    }
+
+    static ErrorContext processContext;
+    return processContext;
+}
+
+void ErrorContext::appendTraces(FFDCData& ffdcData, FFDCSections& sections)
+{
+    std::lock_guard lock(mutex);
+    traces.appendTo(ffdcData, sections);
+}
+
+void ErrorContext::clearTraces()
+{
+    std::lock_guard lock(mutex);
+    traces.clear();
+}
+
+ScopedErrorContext::ScopedErrorContext() :
+    context(std::make_unique<ErrorContext>()), previous(active)
+{
+    active = context.get();
+}
+
+ScopedErrorContext::~ScopedErrorContext()
+{
+    active = previous;
+}
+
+} // namespace pel
+} // namespace openpower
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "trace_buffer.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace openpower
+{
+namespace pel
+{
+
+/**
+ * @class ErrorContext
+ * @brief Error collection state of one PHAL operation
+ *
+ * The trace callbacks add to the context active on the calling thread and
+ * the PELs of a failure only take the traces of that context, so
+ * operations running on different threads don't mix their traces.
+ *
+ * Threads without an installed context share the process context, the
+ * traces are only accessed under the context lock.
+ */
+class ErrorContext
+{
+  public:
+    ErrorContext() = default;
+    ErrorContext(const ErrorContext&) = delete;
+    ErrorContext& operator=(const ErrorContext&) = delete;
+    ErrorContext(ErrorContext&&) = delete;
+    ErrorContext& operator=(ErrorContext&&) = delete;
+
+    /**
+     * @brief Get the context active on the calling thread
+     *
+     * @return installed context, the process context if there is none
+     */
+    static ErrorContext& current();
+
+    /**
+     * @brief Add the traces to PEL data, see TraceBuffer::appendTo()
+     *
+     * @param[in,out] ffdcData - PEL additional data
+     * @param[in,out] sections - PEL binary FFDC sections
+     */
+    void appendTraces(FFDCData& ffdcData, FFDCSections& sections);
+
+    /**
+     * @brief Drop the traces
+     */
+    void clearTraces();
+
+    /**
+     * @brief Call a function with exclusive access to the traces
+     *
+     * @param[in] func - function taking the TraceBuffer
+     *
+     * @return function return value
+     */
+    template <typename Func>
+    auto withTraces(Func&& func)
+    {
+        std::lock_guard lock(mutex);
+        return func(traces);
+    }
+
+  private:
+    /** Guards the traces */
+    std::mutex mutex;
+
+    /** Debug traces of the operation */
+    TraceBuffer traces;
+};
+
+/**
+ * @class ScopedErrorContext
+ * @brief Install a new error context on the calling thread for its lifetime
+ *
+ * The previously active context is restored on destruction, so contexts
+ * nest. The object must be destroyed on the thread which created it.
+ */
+class ScopedErrorContext
+{
+  public:
+    ScopedErrorContext();
+    ~ScopedErrorContext();
+
+    ScopedErrorContext(const ScopedErrorContext&) = delete;
+    ScopedErrorContext& operator=(const ScopedErrorContext&) = delete;
+    ScopedErrorContext(ScopedErrorContext&&) = delete;
+    ScopedErrorContext& operator=(ScopedErrorContext&&) = delete;
+
+    /**
+     * @brief Get the installed context
+     *
+     * @return error context
+     */
+    ErrorContext& get()
+    {
+        return *context;
+    }
+
+  private:
+    /** Heap allocated, the trace arena is too large for a thread stack */
+    std::unique_ptr<ErrorContext> context;
+
+    /** Context active before this one was installed, null for the process
+     *  context */
+    ErrorContext* previous;
+};
+
+} // namespace pel
+} // namespace openpower
@@ -0,0 +1,112 @@
+#include "ffdc_section.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace openpower
+{
+namespace pel
+{
+
+/**
+ * @brief Append an unsigned value in big endian byte order
+ *
+ * @param[in,out] buffer - destination buffer
+ * @param[in] value - value to append
+ */
+template <typename T>
+static void putBE(std::vector<uint8_t>& buffer, T value)
+{
+    for (size_t i = sizeof(T); i > 0; i--)
+    {
+        buffer.push_back(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+    }
+}
+
+FFDCSection::FFDCSection(FFDCSectionType type) : sectionType(type) {}
+
+bool FFDCSection::fits(size_t entrySize) const
+{
+    return size() + entrySize <= FFDC_SECTION_MAX_SIZE;
+}
+
+bool FFDCSection::addRegister(std::string_view target, uint32_t address,
+                              std::span<const uint8_t> value)
+{
+    auto name = target.substr(0, UINT8_MAX);
+    auto length = std::min<size_t>(value.size(), UINT16_MAX);
+    if (!fits(1 + name.size() + 4 + 2 + length))
+    {
+        return false;
+    }
+
+    putBE<uint8_t>(entries, name.size());
+    entries.insert(entries.end(), name.begin(), name.end());
+    putBE<uint32_t>(entries, address);
+    putBE<uint16_t>(entries, length);
+    entries.insert(entries.end(), value.begin(), value.begin() + length);
+    entryCount++;
+    return true;
+}
+
+bool FFDCSection::addRegister(std::string_view target, uint32_t address,
+                              uint32_t value)
+{
+    std::vector<uint8_t> bytes;
+    putBE<uint32_t>(bytes, value);
+    return addRegister(target, address, bytes);
+}
+
+size_t FFDCSection::getTraceEntrySize(std::string_view message)
+{
+    return 4 + 8 + 2 + std::min<size_t>(message.size(), UINT16_MAX);
+}
+
+bool FFDCSection::addTrace(uint32_t seq, time_t timestamp,
+                           std::string_view message)
+{
+    auto text = message.substr(0, UINT16_MAX);
+    if (!fits(getTraceEntrySize(text)))
+    {
+        return false;
+    }
+
+    putBE<uint32_t>(entries, seq);
+    putBE<uint64_t>(entries, timestamp);
+    putBE<uint16_t>(entries, text.size());
+    entries.insert(entries.end(), text.begin(), text.end());
+    entryCount++;
+    return true;
+}
+
+bool FFDCSection::append(const FFDCSection& other)
+{
+    if (other.sectionType != sectionType)
+    {
+        throw std::invalid_argument("FFDC section type mismatch");
+    }
+    if (!fits(other.entries.size()))
+    {
+        return false;
+    }
+
+    entries.insert(entries.end(), other.entries.begin(), other.entries.end());
+    entryCount += other.entryCount;
+    return true;
+}
+
+std::vector<uint8_t> FFDCSection::data() const
+{
+    std::vector<uint8_t> section;
+    section.reserve(size());
+    putBE<uint32_t>(section, FFDC_SECTION_MAGIC);
+    putBE<uint8_t>(section, FFDC_SECTION_VERSION);
+    putBE<uint8_t>(section, static_cast<uint8_t>(sectionType));
+    putBE<uint16_t>(section, 0);
+    putBE<uint32_t>(section, entryCount);
+    section.insert(section.end(), entries.begin(), entries.end());
+    return section;
+}
+
+} // namespace pel
+} // namespace openpower
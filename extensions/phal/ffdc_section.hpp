@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace openpower
+{
+namespace pel
+{
+
+/**
+ * Binary FFDC section layout (big endian, as the PEL itself)
+ *
+ *   Header : magic(4) version(1) type(1) reserved(2) count(4)
+ *   Entries: count x entry of the section type
+ *
+ *   Registers entry: targetLen(1) target(targetLen) address(4)
+ *                    valueLen(2) value(valueLen)
+ *   Traces entry   : seq(4) timestamp(8) messageLen(2) message(messageLen)
+ *
+ * The section is attached to the PEL as a Custom format FFDC file of
+ * sub type FFDC_SECTION_SUBTYPE, which ends up in a PEL user data
+ * section.
+ */
+constexpr uint32_t FFDC_SECTION_MAGIC = 0x50484644; // "PHFD"
+constexpr uint8_t FFDC_SECTION_VERSION = 1;
+constexpr uint8_t FFDC_SECTION_SUBTYPE = 0xCC;
+constexpr size_t FFDC_SECTION_HEADER_SIZE = 12;
+
+/** Section size above which entries are not added, keeps the PEL small */
+constexpr size_t FFDC_SECTION_MAX_SIZE = 8192;
+
+enum class FFDCSectionType : uint8_t
+{
+    Registers = 0x01,
+    Traces = 0x02,
+};
+
+/**
+ * @class FFDCSection
+ * @brief Compact binary section for bulk PEL data
+ *
+ * Register dumps and traces are added as binary entries instead of one
+ * AdditionalData string pair per value, only summary keys are left in
+ * the AdditionalData.
+ */
+class FFDCSection
+{
+  public:
+    FFDCSection() = delete;
+
+    /**
+     * @brief Create an empty section
+     *
+     * @param[in] type - section type, defines the entry layout
+     */
+    explicit FFDCSection(FFDCSectionType type);
+
+    /**
+     * @brief Add a register value to a Registers section
+     *
+     * @param[in] target - target name, truncated to 255 characters
+     * @param[in] address - register address
+     * @param[in] value - register value bytes
+     *
+     * @return false if the section is full and the entry was dropped
+     */
+    bool addRegister(std::string_view target, uint32_t address,
+                     std::span<const uint8_t> value);
+
+    /**
+     * @brief Add a 32 bit register value to a Registers section
+     *
+     * The value is stored big endian.
+     *
+     * @param[in] target - target name, truncated to 255 characters
+     * @param[in] address - register address
+     * @param[in] value - register value
+     *
+     * @return false if the section is full and the entry was dropped
+     */
+    bool addRegister(std::string_view target, uint32_t address,
+                     uint32_t value);
+
+    /**
+     * @brief Add a trace to a Traces section
+     *
+     * @param[in] seq - trace sequence number
+     * @param[in] timestamp - trace time
+     * @param[in] message - trace message
+     *
+     * @return false if the section is full and the entry was dropped
+     */
+    bool addTrace(uint32_t seq, time_t timestamp, std::string_view message);
+
+    /**
+     * @brief Append the entries of another section of the same type
+     *
+     * Throws std::invalid_argument if the types differ.
+     *
+     * @param[in] other - section to append
+     *
+     * @return false if the section is full and entries were dropped
+     */
+    bool append(const FFDCSection& other);
+
+    /**
+     * @brief Get the size of a trace entry
+     *
+     * @param[in] message - trace message
+     *
+     * @return entry size in bytes
+     */
+    static size_t getTraceEntrySize(std::string_view message);
+
+    /** @brief Section type */
+    FFDCSectionType type() const
+    {
+        return sectionType;
+    }
+
+    /** @brief Number of entries */
+    uint32_t count() const
+    {
+        return entryCount;
+    }
+
+    /** @brief Set if the section has no entries */
+    bool empty() const
+    {
+        return entryCount == 0;
+    }
+
+    /** @brief Section size in bytes, header included */
+    size_t size() const
+    {
+        return FFDC_SECTION_HEADER_SIZE + entries.size();
+    }
+
+    /**
+     * @brief Get the section data, header and entries
+     *
+     * @return section bytes
+     */
+    std::vector<uint8_t> data() const;
+
+  private:
+    /** @brief Check an entry of the given size still fits */
+    bool fits(size_t entrySize) const;
+
+    FFDCSectionType sectionType;
+    uint32_t entryCount = 0;
+    std::vector<uint8_t> entries;
+};
+
+using FFDCSections = std::vector<FFDCSection>;
+
+} // namespace pel
+} // namespace openpower
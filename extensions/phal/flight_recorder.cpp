@@ -0,0 +1,191 @@
+#include "flight_recorder.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace openpower
+{
+namespace pel
+{
+
+using namespace phosphor::logging;
+
+constexpr size_t RECORDER_FILE_SIZE =
+    sizeof(RecorderHeader) + (RECORDER_RECORD_COUNT * sizeof(RecorderRecord));
+
+fs::path getRecorderFile(const fs::path& dir, pid_t pid)
+{
+    return dir / std::format("phal-trace-{}", pid);
+}
+
+std::optional<uint64_t> getProcessStartTime(pid_t pid)
+{
+    std::ifstream file(std::format("/proc/{}/stat", pid));
+    std::string stat;
+    if (!std::getline(file, stat))
+    {
+        return std::nullopt;
+    }
+
+    // The command name may contain spaces and parentheses, the fields
+    // are counted from the last ')', starttime is field 22.
+    auto pos = stat.rfind(')');
+    if (pos == std::string::npos)
+    {
+        return std::nullopt;
+    }
+    std::istringstream fields(stat.substr(pos + 1));
+    std::string field;
+    for (int i = 3; i < 22; i++)
+    {
+        fields >> field;
+    }
+    uint64_t startTime = 0;
+    if (!(fields >> startTime))
+    {
+        return std::nullopt;
+    }
+    return startTime;
+}
+
+FlightRecorder::FlightRecorder(const fs::path& dir)
+{
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    auto file = getRecorderFile(dir, getpid());
+    int fd = open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd == -1)
+    {
+        log<level::ERR>(std::format("Failed to create trace recorder "
+                                    "file({}), errorno({}) and errormsg({})",
+                                    file.string(), errno, strerror(errno))
+                            .c_str());
+        throw std::runtime_error("Failed to create trace recorder file");
+    }
+
+    // Allocate the tmpfs pages upfront, so a full /run fails here instead
+    // of with SIGBUS on a later trace.
+    int rc = posix_fallocate(fd, 0, RECORDER_FILE_SIZE);
+    void* addr = MAP_FAILED;
+    if (rc == 0)
+    {
+        addr = mmap(nullptr, RECORDER_FILE_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+        rc = (addr == MAP_FAILED) ? errno : 0;
+    }
+    close(fd);
+
+    if (rc != 0)
+    {
+        log<level::ERR>(std::format("Failed to map trace recorder file({}), "
+                                    "errorno({}) and errormsg({})",
+                                    file.string(), rc, strerror(rc))
+                            .c_str());
+        std::filesystem::remove(file, ec);
+        throw std::runtime_error("Failed to map trace recorder file");
+    }
+
+    header = static_cast<RecorderHeader*>(addr);
+    records = reinterpret_cast<RecorderRecord*>(header + 1);
+
+    header->magic = RECORDER_MAGIC;
+    header->version = RECORDER_VERSION;
+    header->recordSize = sizeof(RecorderRecord);
+    header->recordCount = RECORDER_RECORD_COUNT;
+    header->pid = getpid();
+    header->dirty = 1;
+    header->total = 0;
+    header->startTime = getProcessStartTime(getpid()).value_or(0);
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    munmap(header, RECORDER_FILE_SIZE);
+}
+
+void FlightRecorder::add(const char* message)
+{
+    // Operations on several threads share the recorder, reserve the slot.
+    // A record still being written when the process dies is read back
+    // as is, the reader terminates the message.
+    auto seq = std::atomic_ref<uint32_t>(header->total)
+                   .fetch_add(1, std::memory_order_relaxed);
+
+    auto& record = records[seq % RECORDER_RECORD_COUNT];
+    record.timestamp = time(nullptr);
+    strncpy(record.message, message, sizeof(record.message) - 1);
+    record.message[sizeof(record.message) - 1] = '\0';
+}
+
+void FlightRecorder::markClean()
+{
+    std::atomic_ref<uint32_t>(header->dirty).store(0,
+                                                   std::memory_order_release);
+}
+
+RecorderData readRecorderFile(const fs::path& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error(
+            std::format("Failed to open trace recorder file({})",
+                        file.string()));
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+
+    RecorderData recorder;
+    if (data.size() < sizeof(RecorderHeader))
+    {
+        throw std::runtime_error("Trace recorder file is truncated");
+    }
+    std::memcpy(&recorder.header, data.data(), sizeof(RecorderHeader));
+
+    const auto& header = recorder.header;
+    if ((header.magic != RECORDER_MAGIC) ||
+        (header.version != RECORDER_VERSION) ||
+        (header.recordSize != sizeof(RecorderRecord)) ||
+        (header.recordCount == 0))
+    {
+        throw std::runtime_error("Not a supported trace recorder file");
+    }
+    if (data.size() < sizeof(RecorderHeader) +
+                          (size_t(header.recordCount) * header.recordSize))
+    {
+        throw std::runtime_error("Trace recorder file is truncated");
+    }
+
+    uint32_t first = 0;
+    if (header.total > header.recordCount)
+    {
+        first = header.total - header.recordCount;
+    }
+    for (uint32_t seq = first; seq < header.total; seq++)
+    {
+        RecorderRecord record;
+        std::memcpy(&record,
+                    data.data() + sizeof(RecorderHeader) +
+                        ((seq % header.recordCount) * sizeof(RecorderRecord)),
+                    sizeof(record));
+        record.message[sizeof(record.message) - 1] = '\0';
+        recorder.traces.emplace_back(seq, record.timestamp, record.message);
+    }
+    return recorder;
+}
+
+} // namespace pel
+} // namespace openpower
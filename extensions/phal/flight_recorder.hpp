@@ -0,0 +1,146 @@
+#pragma once
+
+#include "trace_buffer.hpp"
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace openpower
+{
+namespace pel
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * Flight recorder file layout (host byte order)
+ *
+ *   RecorderHeader
+ *   Records : recordCount x RecorderRecord, used as a ring buffer
+ *
+ * The file is created by the process which owns it and named after its
+ * pid. dirty stays set until the process exits cleanly, so a set dirty
+ * marker of a dead process means the process crashed or was killed.
+ * startTime tells the owner apart from a later process reusing the pid.
+ */
+constexpr uint32_t RECORDER_MAGIC = 0x50545243; // "PTRC"
+constexpr uint16_t RECORDER_VERSION = 2;
+constexpr uint32_t RECORDER_RECORD_COUNT = 1024;
+
+struct RecorderHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t recordCount;
+    uint32_t pid;
+    uint32_t dirty;
+    uint32_t total;     // number of records ever added
+    uint64_t startTime; // owner start time, clock ticks since boot
+};
+
+struct RecorderRecord
+{
+    int64_t timestamp;
+    char message[TRACE_MSG_SIZE];
+};
+
+/** @brief Content of a flight recorder file */
+struct RecorderData
+{
+    RecorderHeader header;
+
+    /** Traces as sequence number, timestamp and message, oldest first */
+    std::vector<std::tuple<uint32_t, time_t, std::string>> traces;
+};
+
+/**
+ * @class FlightRecorder
+ * @brief Memory mapped trace file which survives a process crash
+ *
+ * Adding a trace is a copy into the shared mapping, there is no system
+ * call per trace. The kernel keeps the data in the file when the process
+ * dies for any reason.
+ */
+class FlightRecorder
+{
+  public:
+    FlightRecorder() = delete;
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    FlightRecorder(FlightRecorder&&) = delete;
+    FlightRecorder& operator=(FlightRecorder&&) = delete;
+
+    /**
+     * @brief Create and map the recorder file of this process
+     *
+     * Throws std::runtime_error on failure.
+     *
+     * @param[in] dir - recorder file directory
+     */
+    explicit FlightRecorder(const fs::path& dir);
+
+    /**
+     * @brief Unmap the recorder file, the dirty marker is kept
+     */
+    ~FlightRecorder();
+
+    /**
+     * @brief Add trace message, overwriting the oldest one when full
+     *
+     * Safe to call from several threads.
+     *
+     * @param[in] message - trace message, truncated to TRACE_MSG_SIZE
+     */
+    void add(const char* message);
+
+    /**
+     * @brief Clear the dirty marker on a clean exit
+     */
+    void markClean();
+
+  private:
+    RecorderHeader* header;
+    RecorderRecord* records;
+};
+
+/**
+ * @brief Get the recorder file name of a process
+ *
+ * @param[in] dir - recorder file directory
+ * @param[in] pid - process id
+ *
+ * @return recorder file path
+ */
+fs::path getRecorderFile(const fs::path& dir, pid_t pid);
+
+/**
+ * @brief Get the start time of a process
+ *
+ * @param[in] pid - process id
+ *
+ * @return start time in clock ticks since boot, as in /proc/<pid>/stat,
+ *         empty if the process is not running
+ */
+std::optional<uint64_t> getProcessStartTime(pid_t pid);
+
+/**
+ * @brief Read and validate a flight recorder file
+ *
+ * Throws std::runtime_error if the file is not a valid recorder file.
+ *
+ * @param[in] file - recorder file
+ *
+ * @return recorder content
+ */
+RecorderData readRecorderFile(const fs::path& file);
+
+} // namespace pel
+} // namespace openpower
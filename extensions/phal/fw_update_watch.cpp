@@ -5,15 +5,19 @@
 #include "common_utils.hpp"
 #include "create_pel.hpp"
 #include "pdbg_utils.hpp"
+#include "preserved_attrs.hpp"
 
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <libphal.H>
+
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/elog.hpp>
 #include <sdbusplus/exception.hpp>
 
+#include <cstdlib>
 #include <filesystem>
 #include <format>
 
@@ -26,12 +30,7 @@ namespace fwupdate
 using namespace phosphor::logging;
 namespace fs = std::filesystem;
 
-using Message = std::string;
-using Attributes = std::variant<Message>;
-using PropertyName = std::string;
-using PropertyMap = std::map<PropertyName, Attributes>;
-using InterfaceName = std::string;
-using InterfaceMap = std::map<InterfaceName, PropertyMap>;
+constexpr auto ERROR_DEVTREE_BACKUP = "org.open_power.PHAL.Error.devtreeBackup";
 
 void Watch::fwIntfAddedCallback(sdbusplus::message_t& msg)
 {
@@ -52,21 +51,26 @@ void Watch::fwIntfAddedCallback(sdbusplus::message_t& msg)
         return;
     }
 
-    auto iter = interfaceMap.find("xyz.openbmc_project.Software.Activation");
+    auto iter = interfaceMap.find(ACTIVATION_INTERFACE);
     if (iter == interfaceMap.end())
     {
         // Skip not related Software Activation
         return;
     }
 
-    auto attr = iter->second.find("Activation");
-    if (attr == iter->second.end())
+    activationChanged(iter->second);
+}
+
+void Watch::activationChanged(const PropertyMap& properties)
+{
+    auto attr = properties.find("Activation");
+    if (attr == properties.end())
     {
         // Skip not related to Activation property.
         return;
     }
 
-    auto& imageProperty = std::get<InterfaceName>(attr->second);
+    auto& imageProperty = std::get<Message>(attr->second);
     if (imageProperty.empty())
     {
         // Skip, no image property
@@ -77,7 +81,7 @@ void Watch::fwIntfAddedCallback(sdbusplus::message_t& msg)
             "xyz.openbmc_project.Software.Activation.Activations.Ready" &&
         !isSoftwareUpdateInProgress())
     {
-        log<level::INFO>("Software path interface add signal received");
+        log<level::INFO>("Software activation ready signal received");
 
         // Set status to code update in progress.
         // Interface added signal triggered multiple times in code update path,
@@ -86,10 +90,11 @@ void Watch::fwIntfAddedCallback(sdbusplus::message_t& msg)
         // Device tree data collection is required only for the first trigger
         setSoftwareUpdateProgress(true);
 
+        pid_t pid = -1;
         try
         {
-            // Colect device tree data
-            openpower::phal::fwupdate::exportDevtree();
+            // Start device tree data collection
+            pid = openpower::phal::fwupdate::exportDevtree();
         }
         catch (const fs::filesystem_error& e)
         {
@@ -99,17 +104,37 @@ void Watch::fwIntfAddedCallback(sdbusplus::message_t& msg)
             throw std::runtime_error(e.what());
         }
 
-        log<level::INFO>("Successfully exported devtree attribute data");
+        if (pid > 0)
+        {
+            // Don't block the event loop, completion is reported through
+            // the child process event source.
+            exportChild = std::make_unique<sdeventplus::source::Child>(
+                event, pid, WEXITED,
+                std::bind(std::mem_fn(&Watch::exportCompleted), this,
+                          std::placeholders::_1, std::placeholders::_2));
+        }
     }
-
-    return;
 }
 
-void exportDevtree()
+void Watch::exportCompleted(sdeventplus::source::Child&, const siginfo_t* si)
 {
-    constexpr auto ERROR_DEVTREE_BACKUP =
-        "org.open_power.PHAL.Error.devtreeBackup";
+    if ((si->si_code != CLD_EXITED) || (si->si_status != EXIT_SUCCESS))
+    {
+        log<level::ERR>(
+            std::format("Failed to collect attribute export data, code({}) "
+                        "status({})",
+                        si->si_code, si->si_status)
+                .c_str());
+        openpower::pel::createPEL(ERROR_DEVTREE_BACKUP);
+    }
+    else
+    {
+        log<level::INFO>("Successfully exported devtree attribute data");
+    }
+}
 
+pid_t exportDevtree()
+{
     // Check devtree export filter file is present
     auto path = fs::path(DEVTREE_EXPORT_FILTER_FILE);
     if (!fs::exists(path))
@@ -119,7 +144,7 @@ void exportDevtree()
                         DEVTREE_EXPORT_FILTER_FILE)
                 .c_str());
         openpower::pel::createPEL(ERROR_DEVTREE_BACKUP);
-        return;
+        return -1;
     }
 
     // delete export data file if present
@@ -137,41 +162,51 @@ void exportDevtree()
     // Update PDBG_DTB value
     openpower::phal::setDevtreeEnv();
 
-    // Update PDATA_INFODB value
-    openpower::phal::setPdataInfoDBEnv();
-
-    int status = 0;
+    // Collect the attributes in a child process, pdbg targets can only be
+    // initialized once per process and this daemon outlives the devtree
+    // file which is replaced during the code update.
     pid_t pid = fork();
     if (pid == 0)
     {
-        std::string cmd("/usr/bin/attributes ");
-        cmd += "export ";
-        cmd += DEVTREE_EXPORT_FILTER_FILE;
-        cmd += " > ";
-        cmd += DEVTREE_EXP_FILE;
-        execl("/bin/sh", "sh", "-c", cmd.c_str(), 0);
-
-        auto error = errno;
-        log<level::ERR>(std::format("Error occurred during attributes function "
-                                    "execution, errno({})",
-                                    error)
-                            .c_str());
-        // Creating PEL at one place.
-    }
-    else if (pid > 0)
-    {
-        waitpid(pid, &status, 0);
-        if (WEXITSTATUS(status))
+        try
         {
-            log<level::ERR>("Failed to collect attribute export data");
-            openpower::pel::createPEL(ERROR_DEVTREE_BACKUP);
+            openpower::phal::pdbg::init();
+
+            auto attrNames = attrs::readAttrList(DEVTREE_EXPORT_FILTER_FILE);
+
+            // Export only the attributes which differ from the genesis
+            // value in the RO devtree.
+            attrs::Values baseline;
+            try
+            {
+                baseline = attrs::readDevtreeBlob(
+                    openpower::phal::computeRODeviceTreePath(), attrNames);
+            }
+            catch (const std::exception& e)
+            {
+                log<level::ERR>(
+                    std::format("RO devtree not available, exporting all "
+                                "attributes ({})",
+                                e.what())
+                        .c_str());
+            }
+            attrs::writeFile(expFile, attrs::collect(attrNames, baseline));
         }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(
+                std::format("Failed to export attribute data ({})", e.what())
+                    .c_str());
+            _exit(EXIT_FAILURE);
+        }
+        _exit(EXIT_SUCCESS);
     }
-    else
+    else if (pid < 0)
     {
         log<level::ERR>("exportDevtree fork() failed");
-        std::runtime_error("exportDevtree fork() failed");
+        throw std::runtime_error("exportDevtree fork() failed");
     }
+    return pid;
 }
 
 } // namespace fwupdate
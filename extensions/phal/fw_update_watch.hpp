@@ -2,6 +2,13 @@
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/server.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/child.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <variant>
 
 namespace openpower
 {
@@ -11,6 +18,15 @@ namespace fwupdate
 {
 
 static constexpr auto OBJ_SOFTWARE = "/xyz/openbmc_project/software";
+static constexpr auto ACTIVATION_INTERFACE =
+    "xyz.openbmc_project.Software.Activation";
+
+using Message = std::string;
+using Attributes = std::variant<Message>;
+using PropertyName = std::string;
+using PropertyMap = std::map<PropertyName, Attributes>;
+using InterfaceName = std::string;
+using InterfaceMap = std::map<InterfaceName, PropertyMap>;
 
 /** @class Watch
  *  @brief Adds d-bus signal based watch for software path interface add.
@@ -18,12 +34,16 @@ static constexpr auto OBJ_SOFTWARE = "/xyz/openbmc_project/software";
  *  interface add signal and call appropriate function to initiate phal
  *  devtree attribute data collection and save to preserve partition.
  *  Rules:
- *   - Watch for interfaces added for the software path
+ *   - Watch for interfaces added to objects below the software path,
+ *     the bus daemon filters on the signal path and the object path.
+ *     Match rules can't filter on the added interfaces, which are
+ *     checked by the callback
  *   - If interface added is “Activation”
  *   - if Activation property value is “Ready”
  *   - Then software update is going to start
  *   - Collect phal devtree required attribute list and save to
- *     pre-defined location
+ *     pre-defined location, in a child process which completion is
+ *     reported back through the event loop
  *
  */
 class Watch
@@ -38,12 +58,17 @@ class Watch
 
     /** @brief constructs watch for interface add signals.
      *  @param[in] bus -  The Dbus bus object
+     *  @param[in] event - sdeventplus event loop
      */
 
-    Watch(sdbusplus::bus_t& bus) :
+    Watch(sdbusplus::bus_t& bus, const sdeventplus::Event& event) :
+        event(event),
         addMatch(bus,
                  sdbusplus::bus::match::rules::interfacesAdded() +
-                     sdbusplus::bus::match::rules::path(OBJ_SOFTWARE),
+                     sdbusplus::bus::match::rules::path_namespace(
+                         OBJ_SOFTWARE) +
+                     sdbusplus::bus::match::rules::argNpath(
+                         0, std::string(OBJ_SOFTWARE) + "/"),
                  std::bind(std::mem_fn(&Watch::fwIntfAddedCallback), this,
                            std::placeholders::_1))
     {}
@@ -75,17 +100,43 @@ class Watch
      */
     void fwIntfAddedCallback(sdbusplus::message_t& msg);
 
+    /** @brief Start devtree export if activation changed to ready
+     *
+     *  @param[in] properties - Activation interface properties
+     */
+    void activationChanged(const PropertyMap& properties);
+
+    /** @brief Callback function for devtree export child process exit
+     *
+     *  @param[in] source - child event source
+     *  @param[in] si - child process exit information
+     */
+    void exportCompleted(sdeventplus::source::Child& source,
+                         const siginfo_t* si);
+
+    /** @brief sdeventplus event loop */
+    sdeventplus::Event event;
+
     /** @brief sdbusplus signal match for software path add */
     sdbusplus::bus::match_t addMatch;
 
+    /** @brief event source of the devtree export child process */
+    std::unique_ptr<sdeventplus::source::Child> exportChild;
+
     /** @brief indicates whether software update is going on */
     bool softwareUpdateInProgress = false;
 };
 
-/** @brief function to export phal devtree data file based
- * on the filter file,
+/** @brief function to start the export of phal devtree data file
+ * based on the filter file.
+ *
+ * The data is collected by a child process, the caller is responsible
+ * to wait for its completion. SIGCHLD must be blocked when the child is
+ * watched through an sd-event child source.
+ *
+ * @return pid of the export process, -1 if the export is not started
  */
-void exportDevtree();
+pid_t exportDevtree();
 
 } // namespace fwupdate
 } // namespace phal
@@ -11,6 +11,9 @@ extern "C"
 #include <phosphor-logging/log.hpp>
 
 #include <format>
+#include <map>
+#include <mutex>
+#include <optional>
 
 namespace openpower
 {
@@ -19,8 +22,40 @@ namespace phal
 
 using namespace phosphor::logging;
 
+namespace
+{
+
+/** @brief Access targets resolved for a processor */
+struct ProcAccessTargets
+{
+    struct pdbg_target* fsiTarget = nullptr;
+    struct pdbg_target* pibTarget = nullptr;
+
+    /** PIB probe outcome, empty until probed */
+    std::optional<uint32_t> probeRc;
+};
+
+/**
+ * The cache is shared by the threads accessing several processors
+ * concurrently. The lookups are done outside of the lock, concurrent
+ * lookups of the same processor give the same result.
+ */
+std::mutex targetCacheMutex;
+std::map<struct pdbg_target*, ProcAccessTargets> targetCache;
+
+} // namespace
+
 pdbg_target* getFsiTarget(struct pdbg_target* procTarget)
 {
+    {
+        std::lock_guard lock(targetCacheMutex);
+        auto it = targetCache.find(procTarget);
+        if ((it != targetCache.end()) && it->second.fsiTarget)
+        {
+            return it->second.fsiTarget;
+        }
+    }
+
     struct pdbg_target* fsiTarget = nullptr;
     pdbg_for_each_target("fsi", procTarget, fsiTarget)
     {
@@ -35,11 +70,22 @@ pdbg_target* getFsiTarget(struct pdbg_target* procTarget)
         return nullptr;
     }
 
+    std::lock_guard lock(targetCacheMutex);
+    targetCache[procTarget].fsiTarget = fsiTarget;
     return fsiTarget;
 }
 
 uint32_t probeTarget(struct pdbg_target* procTarget)
 {
+    {
+        std::lock_guard lock(targetCacheMutex);
+        auto it = targetCache.find(procTarget);
+        if ((it != targetCache.end()) && it->second.probeRc)
+        {
+            return *it->second.probeRc;
+        }
+    }
+
     struct pdbg_target* pibTarget = nullptr;
     pdbg_for_each_target("pib", procTarget, pibTarget)
     {
@@ -53,15 +99,74 @@ uint32_t probeTarget(struct pdbg_target* procTarget)
             entry("PROC_TARGET_PATH=%s", pdbg_target_path(procTarget)));
         return -1;
     }
+
+    uint32_t rc = 0;
     // probe PIB and ensure it's enabled
     if (PDBG_TARGET_ENABLED != pdbg_target_probe(pibTarget))
     {
         log<level::ERR>(
             "probe on pib target failed",
             entry("PIB_TARGET_PATH=%s", pdbg_target_path(pibTarget)));
-        return -1;
+        rc = -1;
     }
-    return 0;
+
+    std::lock_guard lock(targetCacheMutex);
+    auto& cached = targetCache[procTarget];
+    cached.pibTarget = pibTarget;
+    cached.probeRc = rc;
+    return rc;
+}
+
+void probeProcTargets(const std::vector<struct pdbg_target*>& procTargets)
+{
+    for (auto procTarget : procTargets)
+    {
+        for (auto targetClass : {"fsi", "pib", "sbefifo"})
+        {
+            struct pdbg_target* target;
+            pdbg_for_each_target(targetClass, procTarget, target)
+            {
+                // the users of the target report a failed probe
+                pdbg_target_probe(target);
+            }
+        }
+    }
+}
+
+void invalidateTargetCache(struct pdbg_target* procTarget)
+{
+    std::lock_guard lock(targetCacheMutex);
+    if (procTarget == nullptr)
+    {
+        targetCache.clear();
+    }
+    else
+    {
+        targetCache.erase(procTarget);
+    }
+}
+
+/**
+ * @brief Read a CFAM register through a resolved and probed FSI target
+ *
+ * @param[in] fsiTarget - FSI target
+ * @param[in] reg - The register address to read
+ * @param[out] val - The value read from the register
+ *
+ * @return 0 on success, non-0 on failure
+ */
+static uint32_t readCFAM(struct pdbg_target* fsiTarget, const uint32_t reg,
+                         uint32_t& val)
+{
+    auto rc = fsi_read(fsiTarget, reg, &val);
+    if (rc)
+    {
+        log<level::ERR>(
+            "failed to read input cfam", entry("RC=%u", rc),
+            entry("CFAM=0x%X", reg),
+            entry("FSI_TARGET_PATH=%s", pdbg_target_path(fsiTarget)));
+    }
+    return rc;
 }
 
 uint32_t getCFAM(struct pdbg_target* procTarget, const uint32_t reg,
@@ -81,16 +186,41 @@ uint32_t getCFAM(struct pdbg_target* procTarget, const uint32_t reg,
         return rc;
     }
 
-    rc = fsi_read(fsiTarget, reg, &val);
+    return readCFAM(fsiTarget, reg, val);
+}
+
+uint32_t getCFAMs(struct pdbg_target* procTarget,
+                  std::span<const uint32_t> regs,
+                  std::vector<std::optional<uint32_t>>& vals)
+{
+    vals.assign(regs.size(), std::nullopt);
+
+    pdbg_target* fsiTarget = getFsiTarget(procTarget);
+    if (nullptr == fsiTarget)
+    {
+        log<level::ERR>("getCFAMs: fsi path or target not found");
+        return -1;
+    }
+
+    auto rc = probeTarget(procTarget);
     if (rc)
     {
-        log<level::ERR>(
-            "failed to read input cfam", entry("RC=%u", rc),
-            entry("CFAM=0x%X", reg),
-            entry("FSI_TARGET_PATH=%s", pdbg_target_path(fsiTarget)));
+        // probe function logged details to journal
         return rc;
     }
-    return 0;
+
+    for (size_t i = 0; i < regs.size(); i++)
+    {
+        uint32_t val = 0;
+        auto readRc = readCFAM(fsiTarget, regs[i], val);
+        if (readRc)
+        {
+            rc = rc ? rc : readRc;
+            continue;
+        }
+        vals[i] = val;
+    }
+    return rc;
 }
 
 uint32_t putCFAM(struct pdbg_target* procTarget, const uint32_t reg,
@@ -149,5 +279,35 @@ void setPdataInfoDBEnv()
     }
 }
 
+std::filesystem::path computeRODeviceTreePath()
+{
+    namespace fs = std::filesystem;
+
+    // Symbolic links are not created for RO files, compute the lid name
+    // for the RW symbolic link and use it to compute RO file.
+    // Example:
+    // RW file = /media/hostfw/running/DEVTREE -> 81e00672.lid
+    // RO file = /media/hostfw/running-ro/ + 81e00672.lid
+    fs::path rwFileName = fs::read_symlink(CEC_DEVTREE_RW_PATH);
+    if (rwFileName.empty())
+    {
+        std::string err =
+            std::format("Failed to read the target file "
+                        "for the RW device tree symbolic link ({})",
+                        CEC_DEVTREE_RW_PATH);
+        log<level::ERR>(err.c_str());
+        throw std::runtime_error(err);
+    }
+    fs::path roFilePath = CEC_DEVTREE_RO_BASE_PATH / rwFileName;
+    if (!fs::exists(roFilePath))
+    {
+        auto err = std::format("RO device tree file ({}) does not exist",
+                               roFilePath.string());
+        log<level::ERR>(err.c_str());
+        throw std::runtime_error(err);
+    }
+    return roFilePath;
+}
+
 } // namespace phal
 } // namespace openpower
@@ -2,6 +2,12 @@
 
 #include <libipl.H>
 
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
 extern "C"
 {
 #include <libpdbg.h>
@@ -24,6 +30,23 @@ namespace phal
 uint32_t getCFAM(struct pdbg_target* procTarget, const uint32_t reg,
                  uint32_t& val);
 
+/**
+ *  @brief  Read a set of CFAM registers
+ *
+ *  The FSI target is resolved and probed once for all the registers.
+ *  A failed read doesn't stop the reads of the next registers.
+ *
+ *  @param[in]  procTarget - Processor target to perform the operation on
+ *  @param[in]  regs - The register addresses to read
+ *  @param[out] vals - The values read, in the order of regs, empty for
+ *                     the registers which could not be read
+ *
+ *  @return 0 if all the registers were read, else the first failure rc
+ */
+uint32_t getCFAMs(struct pdbg_target* procTarget,
+                  std::span<const uint32_t> regs,
+                  std::vector<std::optional<uint32_t>>& vals);
+
 /**
  *  @brief  Write the input CFAM register
  *
@@ -39,6 +62,8 @@ uint32_t putCFAM(struct pdbg_target* procTarget, const uint32_t reg,
 /**
  *  @brief  Helper function to find FSI target needed for FSI operations
  *
+ *  The FSI target is cached per processor, see invalidateTargetCache().
+ *
  *  @param[in]  procTarget - Processor target to find the FSI target on
  *
  *  @return Valid pointer to FSI target on success, nullptr on failure
@@ -50,6 +75,8 @@ pdbg_target* getFsiTarget(struct pdbg_target* procTarget);
  *
  *  The probe call only has to happen once per application start so ensure
  *  this function only probes once no matter how many times it's called.
+ *  The PIB target and the probe outcome are cached per processor, see
+ *  invalidateTargetCache().
  *
  *  @param[in]  procTarget - Processor target to probe
  *
@@ -57,6 +84,29 @@ pdbg_target* getFsiTarget(struct pdbg_target* procTarget);
  */
 uint32_t probeTarget(struct pdbg_target* procTarget);
 
+/**
+ *  @brief  Probe the access targets of processors one at a time
+ *
+ *  libpdbg is not thread safe and probing a target also probes its
+ *  parents, which the processors share. The FSI, PIB and SBE FIFO
+ *  targets are probed here before the processors are accessed from
+ *  several threads.
+ *
+ *  @param[in]  procTargets - Processor targets to probe
+ */
+void probeProcTargets(const std::vector<struct pdbg_target*>& procTargets);
+
+/**
+ *  @brief  Forget the cached FSI/PIB targets and probe outcomes
+ *
+ *  Must be called when the pdbg targets are initialized again, the
+ *  cached target pointers are stale then. Also lets a failed probe be
+ *  retried.
+ *
+ *  @param[in]  procTarget - Processor target, nullptr for all of them
+ */
+void invalidateTargetCache(struct pdbg_target* procTarget = nullptr);
+
 /**
  * @brief Helper function to set PDBG_DTB
  *
@@ -71,5 +121,14 @@ void setDevtreeEnv();
  */
 void setPdataInfoDBEnv();
 
+/**
+ * @brief Compute RO device tree file path from RW symbolic link
+ *
+ * Throws an exception on failure.
+ *
+ * @return RO device tree file path
+ */
+std::filesystem::path computeRODeviceTreePath();
+
 } // namespace phal
 } // namespace openpower
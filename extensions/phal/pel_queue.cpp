@@ -0,0 +1,241 @@
+#include "pel_queue.hpp"
+
+#include "util.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace openpower
+{
+using namespace phosphor::logging;
+
+namespace pel
+{
+
+constexpr auto loggingObjectPath = "/xyz/openbmc_project/logging";
+constexpr auto loggingInterface = "xyz.openbmc_project.Logging.Create";
+
+QueuedFFDC::QueuedFFDC(FFDCFormat format, uint8_t subType, uint8_t version,
+                       int fd) :
+    format(format), subType(subType), version(version),
+    fd(fcntl(fd, F_DUPFD_CLOEXEC, 0))
+{
+    if (this->fd == -1)
+    {
+        log<level::ERR>(std::format("Failed to duplicate ffdc file fd({}), "
+                                    "errorno({}) and errormsg({})",
+                                    fd, errno, strerror(errno))
+                            .c_str());
+        throw std::runtime_error("Failed to duplicate ffdc file descriptor");
+    }
+}
+
+QueuedFFDC::QueuedFFDC(QueuedFFDC&& other) noexcept :
+    format(other.format), subType(other.subType), version(other.version),
+    fd(std::exchange(other.fd, -1))
+{}
+
+QueuedFFDC::~QueuedFFDC()
+{
+    if (fd != -1)
+    {
+        close(fd);
+    }
+}
+
+/**
+ * @brief Submit the PEL request to the logging service
+ *
+ * Errors are traced and dropped, there is no caller left to report to.
+ *
+ * @param[in] bus - D-Bus connection
+ * @param[in] request - PEL request
+ */
+static void submitRequest(sdbusplus::bus_t& bus, const PELRequest& request)
+{
+    auto additionalData = request.additionalData;
+    if (request.count > 1)
+    {
+        additionalData.insert_or_assign("COALESCED_COUNT",
+                                        std::to_string(request.count));
+    }
+
+    std::vector<std::tuple<FFDCFormat, uint8_t, uint8_t,
+                           sdbusplus::message::unix_fd>>
+        ffdcInfo;
+    for (const auto& ffdc : request.ffdcFiles)
+    {
+        // The duplicated fd shares the file offset, which the caller may
+        // have left anywhere.
+        lseek(ffdc.fd, 0, SEEK_SET);
+        ffdcInfo.emplace_back(ffdc.format, ffdc.subType, ffdc.version,
+                              ffdc.fd);
+    }
+
+    try
+    {
+        auto service = util::getService(bus, loggingObjectPath,
+                                        loggingInterface);
+        auto method = bus.new_method_call(service.c_str(), loggingObjectPath,
+                                          loggingInterface,
+                                          "CreateWithFFDCFiles");
+        auto level =
+            sdbusplus::xyz::openbmc_project::Logging::server::convertForMessage(
+                request.severity);
+        method.append(request.event, level, additionalData, ffdcInfo);
+        bus.call_noreply(method);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(std::format("Failed to create PEL event({}), "
+                                    "EXCEPTION({})",
+                                    request.event, e.what())
+                            .c_str());
+    }
+}
+
+SubmitQueue& SubmitQueue::get()
+{
+    // Never destroyed, see stop()
+    static auto* queue = new SubmitQueue();
+    return *queue;
+}
+
+SubmitQueue::SubmitQueue() : owner(getpid())
+{
+    // stop() drains the queue from an atexit handler and the worker
+    // looks up the logging service, the connection and the caches must
+    // outlive the handler.
+    util::initBus();
+
+    worker = std::thread(&SubmitQueue::run, this);
+    std::atexit(&SubmitQueue::stop);
+}
+
+void SubmitQueue::stop()
+{
+    auto& queue = get();
+
+    // atexit handlers are inherited by forked children, which don't have
+    // the worker thread.
+    if (queue.owner != getpid())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.stopping = true;
+    }
+    queue.queued.notify_one();
+    queue.submitted.notify_all();
+
+    if (queue.worker.joinable())
+    {
+        queue.worker.join();
+    }
+}
+
+void SubmitQueue::submit(PELRequest&& request)
+{
+    if (owner != getpid())
+    {
+        submitRequest(util::getBus(), request);
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+
+    // Late request from an atexit handler or another thread, the worker
+    // may be gone already.
+    if (stopping)
+    {
+        guard.unlock();
+        submitRequest(util::getBus(), request);
+        return;
+    }
+
+    if (!request.coalesceKey.empty())
+    {
+        // The in flight request is already on its way, skip it
+        auto it = requests.begin() + (busy ? 1 : 0);
+        for (; it != requests.end(); ++it)
+        {
+            if (it->coalesceKey == request.coalesceKey)
+            {
+                it->count += request.count;
+                return;
+            }
+        }
+    }
+
+    if (requests.size() >= PEL_QUEUE_DEPTH)
+    {
+        log<level::INFO>(
+            std::format("PEL queue full, waiting to queue event({})",
+                        request.event)
+                .c_str());
+        submitted.wait(guard, [this] {
+            return (requests.size() < PEL_QUEUE_DEPTH) || stopping;
+        });
+        if (stopping)
+        {
+            guard.unlock();
+            submitRequest(util::getBus(), request);
+            return;
+        }
+    }
+
+    requests.emplace_back(std::move(request));
+    guard.unlock();
+    queued.notify_one();
+}
+
+void SubmitQueue::drain()
+{
+    if (owner != getpid())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    submitted.wait(guard, [this] { return requests.empty(); });
+}
+
+void SubmitQueue::run()
+{
+    // sd-bus connections are not thread safe, so the worker has its own
+    auto bus = sdbusplus::bus::new_default();
+
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
+    {
+        queued.wait(guard, [this] { return !requests.empty() || stopping; });
+        if (requests.empty())
+        {
+            break;
+        }
+
+        busy = true;
+        guard.unlock();
+        submitRequest(bus, requests.front());
+        guard.lock();
+        busy = false;
+
+        requests.pop_front();
+        submitted.notify_all();
+    }
+}
+
+} // namespace pel
+} // namespace openpower
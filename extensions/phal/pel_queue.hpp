@@ -0,0 +1,171 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <xyz/openbmc_project/Logging/Create/server.hpp>
+#include <xyz/openbmc_project/Logging/Entry/server.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openpower
+{
+namespace pel
+{
+
+using Severity = sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level;
+using FFDCFormat =
+    sdbusplus::xyz::openbmc_project::Logging::server::Create::FFDCFormat;
+
+/** Maximum number of PEL requests waiting for submission */
+constexpr size_t PEL_QUEUE_DEPTH = 16;
+
+/**
+ * @class QueuedFFDC
+ * @brief FFDC file attached to a queued PEL request
+ *
+ * Holds its own duplicate of the caller file descriptor, so the caller
+ * is free to close (and remove) its file once the request is queued.
+ */
+class QueuedFFDC
+{
+  public:
+    QueuedFFDC() = delete;
+    QueuedFFDC(const QueuedFFDC&) = delete;
+    QueuedFFDC& operator=(const QueuedFFDC&) = delete;
+    QueuedFFDC& operator=(QueuedFFDC&&) = delete;
+
+    /**
+     * @brief Duplicate the given ffdc file descriptor
+     *
+     * Throws std::runtime_error if the descriptor can't be duplicated.
+     *
+     * @param[in] format - ffdc file format
+     * @param[in] subType - ffdc file sub type
+     * @param[in] version - ffdc file version
+     * @param[in] fd - ffdc file descriptor, not owned
+     */
+    QueuedFFDC(FFDCFormat format, uint8_t subType, uint8_t version, int fd);
+
+    QueuedFFDC(QueuedFFDC&& other) noexcept;
+
+    ~QueuedFFDC();
+
+    FFDCFormat format;
+    uint8_t subType;
+    uint8_t version;
+    int fd;
+};
+
+/** @brief Fully built PEL create request */
+struct PELRequest
+{
+    std::string event;
+    Severity severity;
+    std::map<std::string, std::string> additionalData;
+    std::vector<QueuedFFDC> ffdcFiles;
+
+    /**
+     * Requests with the same non empty key which are still waiting in the
+     * queue are folded into one PEL, see SubmitQueue::submit().
+     */
+    std::string coalesceKey;
+
+    /** Number of requests folded into this one */
+    uint32_t count = 1;
+};
+
+/**
+ * @class SubmitQueue
+ * @brief Submit PELs to the logging service from a worker thread
+ *
+ * Callers hand over fully built requests and return immediately, instead
+ * of blocking on the logging service D-Bus call. The worker submits the
+ * requests in order on its own D-Bus connection. The queue depth is
+ * bounded by PEL_QUEUE_DEPTH, and submit() waits for a free slot when
+ * the queue is full.
+ *
+ * Pending requests are submitted before the process exits, drain() can
+ * be used to wait for them explicitly. The queue is never destroyed, so
+ * a forked child never tears down the worker of its parent.
+ */
+class SubmitQueue
+{
+  public:
+    SubmitQueue(const SubmitQueue&) = delete;
+    SubmitQueue& operator=(const SubmitQueue&) = delete;
+    SubmitQueue(SubmitQueue&&) = delete;
+    SubmitQueue& operator=(SubmitQueue&&) = delete;
+
+    /**
+     * @brief Get the process wide queue
+     */
+    static SubmitQueue& get();
+
+    /**
+     * @brief Queue a PEL request for submission
+     *
+     * If a request with the same coalesce key is still waiting in the
+     * queue, the new request is folded into it and the PEL carries the
+     * number of folded requests in COALESCED_COUNT additional data.
+     *
+     * In a forked child the worker thread does not exist, and once the
+     * queue is stopped at exit it may be gone, so the request is then
+     * submitted synchronously instead.
+     *
+     * @param[in] request - PEL request
+     */
+    void submit(PELRequest&& request);
+
+    /**
+     * @brief Wait until all the queued requests are submitted
+     */
+    void drain();
+
+  private:
+    SubmitQueue();
+
+    /**
+     * @brief Drain the queue and stop the worker thread
+     *
+     * Registered with atexit() by the owner process, so the queue is
+     * drained on every normal exit path, including returning from main.
+     */
+    static void stop();
+
+    /**
+     * @brief Worker thread main loop
+     */
+    void run();
+
+    /** Pending requests, the front one is in flight while busy is set */
+    std::deque<PELRequest> requests;
+
+    /** Set while the worker submits the front request */
+    bool busy = false;
+
+    /** Set to stop the worker once the queue is empty */
+    bool stopping = false;
+
+    /** Process which owns the worker thread */
+    pid_t owner;
+
+    std::mutex lock;
+
+    /** Signalled when a request is queued or the worker needs to stop */
+    std::condition_variable queued;
+
+    /** Signalled when a request is submitted */
+    std::condition_variable submitted;
+
+    std::thread worker;
+};
+
+} // namespace pel
+} // namespace openpower
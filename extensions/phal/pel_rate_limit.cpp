@@ -0,0 +1,262 @@
+#include "config.h"
+
+#include "pel_rate_limit.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+
+namespace openpower
+{
+namespace pel
+{
+
+using namespace phosphor::logging;
+using json = nlohmann::json;
+using namespace std::chrono_literals;
+
+/**
+ * Events which are known to repeat during reset storms or with flapping
+ * hardware.
+ */
+static const std::vector<RateLimitPolicy> policies = {
+    // checkHostRunning on every host reset attempt
+    {"org.open_power.PHAL.Error.HostRunning", Severity::Error, {}, 10min, 1},
+    // threadStopAll, per processor and chip-op
+    {"org.open_power.Processor.Error.SbeChipOpFailure",
+     Severity::Informational,
+     {"SRC6"},
+     10min,
+     1},
+    // Hardware isolation policy settings read failures on every boot
+    {"org.open_power.PHAL.Error.Boot", Severity::Error, {"REASON_FOR_PEL"},
+     1h, 1},
+    // Clock logger, also created on every service start and on functional
+    // state changes
+    {"org.open_power.PHAL.Info.ClockDailyLog",
+     Severity::Informational,
+     {"COLLECTION_REASON"},
+     12h,
+     1},
+};
+
+/** How long dropped duplicate counts are kept after the window expired */
+constexpr std::chrono::seconds SUPPRESSED_RETENTION = 24h;
+
+const RateLimitPolicy* getRateLimitPolicy(const std::string& event,
+                                          const Severity severity,
+                                          const FFDCData& ffdcData)
+{
+    for (const auto& policy : policies)
+    {
+        if ((policy.event != event) || (policy.severity != severity))
+        {
+            continue;
+        }
+        bool hasKeys = std::ranges::all_of(policy.keys, [&ffdcData](
+                                                            auto key) {
+            return std::ranges::any_of(ffdcData, [key](const auto& data) {
+                return data.first == key;
+            });
+        });
+        return hasKeys ? &policy : nullptr;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Build the duplicate key of the PEL
+ *
+ * @param[in] policy - rate limit policy of the PEL
+ * @param[in] ffdcData - failure data of the PEL
+ *
+ * @return key
+ */
+static std::string getDuplicateKey(const RateLimitPolicy& policy,
+                                   const FFDCData& ffdcData)
+{
+    auto key = std::format("{}|{}", policy.event,
+                           static_cast<int>(policy.severity));
+    for (auto name : policy.keys)
+    {
+        auto it = std::ranges::find_if(ffdcData, [name](const auto& data) {
+            return data.first == name;
+        });
+        key += std::format("|{}={}", name, it->second);
+    }
+    return key;
+}
+
+/**
+ * @brief Read the whole history file
+ *
+ * @param[in] fd - history file descriptor
+ *
+ * @return history, empty if the file is empty or not valid
+ */
+static json readHistory(int fd)
+{
+    std::string data;
+    char buffer[4096];
+    ssize_t rc;
+    while ((rc = pread(fd, buffer, sizeof(buffer), data.size())) > 0)
+    {
+        data.append(buffer, rc);
+    }
+
+    auto history = json::parse(data, nullptr, false);
+    if (!history.is_object())
+    {
+        return json::object();
+    }
+    return history;
+}
+
+/**
+ * @brief Replace the history file content
+ *
+ * @param[in] fd - history file descriptor
+ * @param[in] historyFile - history file path, for the traces
+ * @param[in] history - history to write
+ */
+static void writeHistory(int fd, const std::filesystem::path& historyFile,
+                         const json& history)
+{
+    auto data = history.dump();
+    if ((ftruncate(fd, 0) == -1) ||
+        (pwrite(fd, data.data(), data.size(), 0) !=
+         static_cast<ssize_t>(data.size())))
+    {
+        log<level::ERR>(std::format("Failed to write PEL history file({}), "
+                                    "errorno({}) and errormsg({})",
+                                    historyFile.string(), errno,
+                                    strerror(errno))
+                            .c_str());
+    }
+}
+
+std::optional<uint32_t> checkRateLimit(const std::string& event,
+                                       const Severity severity,
+                                       const FFDCData& ffdcData)
+{
+    return checkRateLimit(event, severity, ffdcData, PEL_HISTORY_FILE);
+}
+
+std::optional<uint32_t>
+    checkRateLimit(const std::string& event, const Severity severity,
+                   const FFDCData& ffdcData,
+                   const std::filesystem::path& historyFile)
+{
+    auto policy = getRateLimitPolicy(event, severity, ffdcData);
+    if (policy == nullptr)
+    {
+        return 0;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(historyFile.parent_path(), ec);
+
+    int fd = open(historyFile.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd == -1)
+    {
+        log<level::ERR>(std::format("Failed to open PEL history file({}), "
+                                    "errorno({}) and errormsg({})",
+                                    historyFile.string(), errno,
+                                    strerror(errno))
+                            .c_str());
+        return 0;
+    }
+
+    // Released by close()
+    if (flock(fd, LOCK_EX) == -1)
+    {
+        log<level::ERR>(std::format("Failed to lock PEL history file({}), "
+                                    "errorno({}) and errormsg({})",
+                                    historyFile.string(), errno,
+                                    strerror(errno))
+                            .c_str());
+        close(fd);
+        return 0;
+    }
+
+    // Monotonic clock is shared by all processes and survives wall clock
+    // changes, /run does not survive a reboot anyway.
+    const int64_t now =
+        std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+
+    auto history = readHistory(fd);
+
+    // Drop expired entries, unless they still carry a dropped count
+    // which has not been reported yet.
+    for (auto it = history.begin(); it != history.end();)
+    {
+        auto expires = it->value("expires", int64_t(0));
+        auto suppressed = it->value("suppressed", uint32_t(0));
+        if ((expires <= now) &&
+            ((suppressed == 0) ||
+             (expires + SUPPRESSED_RETENTION.count() <= now)))
+        {
+            it = history.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    std::optional<uint32_t> result = 0;
+    auto key = getDuplicateKey(*policy, ffdcData);
+    auto& entry = history[key];
+
+    if (entry.is_object() && (entry.value("expires", int64_t(0)) > now))
+    {
+        auto created = entry.value("created", uint32_t(0));
+        if (created < policy->maxCount)
+        {
+            entry["created"] = created + 1;
+            result = entry.value("suppressed", uint32_t(0));
+            entry["suppressed"] = 0;
+        }
+        else
+        {
+            entry["suppressed"] = entry.value("suppressed", uint32_t(0)) + 1;
+            result = std::nullopt;
+        }
+    }
+    else
+    {
+        // New window, report the duplicates dropped in the previous one
+        if (entry.is_object())
+        {
+            result = entry.value("suppressed", uint32_t(0));
+        }
+        entry = {{"expires", now + policy->window.count()},
+                 {"created", 1},
+                 {"suppressed", 0}};
+    }
+
+    writeHistory(fd, historyFile, history);
+    close(fd);
+
+    if (!result)
+    {
+        log<level::INFO>(
+            std::format("Dropping duplicate PEL event({}) key({})", event, key)
+                .c_str());
+    }
+    return result;
+}
+
+} // namespace pel
+} // namespace openpower
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <xyz/openbmc_project/Logging/Entry/server.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace openpower
+{
+namespace pel
+{
+
+using FFDCData = std::vector<std::pair<std::string, std::string>>;
+using Severity = sdbusplus::xyz::openbmc_project::Logging::server::Entry::Level;
+
+/**
+ * @brief Rate limit policy of one PEL event
+ *
+ * PELs of the event and severity which carry the same values for all the
+ * key FFDC entries are duplicates. At most maxCount duplicates are created
+ * per window, the others are dropped and counted. The count is reported
+ * in SUPPRESSED_COUNT additional data of the next created duplicate.
+ */
+struct RateLimitPolicy
+{
+    std::string_view event;
+    Severity severity;
+    std::vector<std::string_view> keys;
+    std::chrono::seconds window;
+    uint32_t maxCount;
+};
+
+/**
+ * @brief Get the rate limit policy of the PEL
+ *
+ * A policy applies only when the PEL carries all the policy keys, so
+ * PELs without them are never dropped.
+ *
+ * @param[in] event - the event type
+ * @param[in] severity - severity of the log
+ * @param[in] ffdcData - failure data of the PEL
+ *
+ * @return policy, or nullptr if the PEL is not rate limited
+ */
+const RateLimitPolicy* getRateLimitPolicy(const std::string& event,
+                                          const Severity severity,
+                                          const FFDCData& ffdcData);
+
+/**
+ * @brief Check the PEL against its rate limit policy
+ *
+ * The history is kept in PEL_HISTORY_FILE, shared under a file lock by
+ * all the processes creating PELs, so duplicates are also caught across
+ * service restarts. History errors never drop a PEL.
+ *
+ * @param[in] event - the event type
+ * @param[in] severity - severity of the log
+ * @param[in] ffdcData - failure data of the PEL
+ *
+ * @return std::nullopt if the PEL is to be dropped, otherwise the number
+ *         of duplicates dropped since the last created one
+ */
+std::optional<uint32_t> checkRateLimit(const std::string& event,
+                                       const Severity severity,
+                                       const FFDCData& ffdcData);
+
+/**
+ * @brief Check the PEL against its rate limit policy, with the history
+ *        kept in the given file
+ *
+ * @param[in] event - the event type
+ * @param[in] severity - severity of the log
+ * @param[in] ffdcData - failure data of the PEL
+ * @param[in] historyFile - rate limit history file
+ *
+ * @return std::nullopt if the PEL is to be dropped, otherwise the number
+ *         of duplicates dropped since the last created one
+ */
+std::optional<uint32_t>
+    checkRateLimit(const std::string& event, const Severity severity,
+                   const FFDCData& ffdcData,
+                   const std::filesystem::path& historyFile);
+
+} // namespace pel
+} // namespace openpower
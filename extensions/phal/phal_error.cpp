@@ -3,12 +3,22 @@ extern "C"
 #include <libpdbg.h>
 }
 
+#include "config.h"
+
+#include "callout.hpp"
 #include "create_pel.hpp"
 #include "dump_utils.hpp"
+#include "error_context.hpp"
 #include "extensions/phal/common_utils.hpp"
+#include "extensions/phal/pdbg_utils.hpp"
+#include "flight_recorder.hpp"
+#include "parallel_ops.hpp"
 #include "phal_error.hpp"
+#include "trace_buffer.hpp"
 #include "util.hpp"
 
+#include <pthread.h>
+
 #include <attributes_info.H>
 #include <libekb.H>
 #include <libphal.H>
@@ -17,14 +27,20 @@ extern "C"
 #include <phosphor-logging/elog.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
 #include <format>
 #include <iomanip>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace openpower
 {
@@ -64,23 +80,47 @@ struct TargetInfo
  * The value for constexpr defined based on pdbg_target_traverse function usage.
  */
 constexpr int continueTgtTraversal = 0;
-constexpr int requireAttrFound = 1;
-constexpr int requireAttrNotFound = 2;
 
 /**
- * @brief Used to get target location code from phal device tree
+ * Device tree target of a PHYS_BIN_PATH and its attributes required for
+ * the callouts, which are read on the first lookup of the target.
+ */
+struct IndexedTarget
+{
+    struct pdbg_target* target;
+
+    bool attrsRead = false;
+    ATTR_LOCATION_CODE_Type locationCode{};
+    ATTR_PHYS_DEV_PATH_Type physDevPath{};
+    ATTR_MRU_ID_Type mruId = 0;
+};
+
+using PhysBinPath = std::vector<uint8_t>;
+
+/**
+ * PHYS_BIN_PATH to target index, built by one device tree traversal on
+ * the first callout lookup of the process.
+ */
+struct TargetIndex
+{
+    std::mutex lock;
+    bool built = false;
+    std::map<PhysBinPath, IndexedTarget> targets;
+};
+
+static TargetIndex targetIndex;
+
+/**
+ * @brief Used to add a target to the PHYS_BIN_PATH index
  *
  * @param[in] target current device tree target
- * @param[out] appPrivData used for accessing|storing from|to application
+ * @param[out] appPrivData target index
  *
  * @return 0 to continue traverse, non-zero to stop traverse
  */
-int pdbgCallbackToGetTgtReqAttrsVal(struct pdbg_target* target,
-                                    void* appPrivData)
+int pdbgCallbackToIndexTarget(struct pdbg_target* target, void* appPrivData)
 {
-    using namespace openpower::phal::pdbg;
-
-    TargetInfo* targetInfo = static_cast<TargetInfo*>(appPrivData);
+    auto* index = static_cast<TargetIndex*>(appPrivData);
 
     ATTR_PHYS_BIN_PATH_Type physBinPath;
     /**
@@ -88,12 +128,10 @@ int pdbgCallbackToGetTgtReqAttrsVal(struct pdbg_target* target,
      * Should not use direct pdbg api to read attribute. Need to use DT_GET_PROP
      * macro for bmc app's and this will call libdt-api api but, it will print
      * "pdbg_target_get_attribute failed" trace if attribute is not found and
-     * this callback will call recursively by using pdbg_target_traverse() until
-     * find expected attribute based on return code from this callback. Because,
-     * need to do target iteration to get actual attribute (ATTR_PHYS_BIN_PATH)
-     * value when device tree target info doesn't know to read attribute from
-     * device tree. So, Due to this error trace user will get confusion while
-     * looking traces. Hence using pdbg api to avoid trace until libdt-api
+     * this callback will call recursively by using pdbg_target_traverse() for
+     * all the targets, many of which don't have the attribute
+     * (ATTR_PHYS_BIN_PATH). So, Due to this error trace user will get
+     * confusion while looking traces. Hence using pdbg api to avoid trace until libdt-api
      * provides log level setup.
      */
     if (!pdbg_target_get_attribute(
@@ -104,20 +142,32 @@ int pdbgCallbackToGetTgtReqAttrsVal(struct pdbg_target* target,
         return continueTgtTraversal;
     }
 
-    if (std::memcmp(physBinPath, targetInfo->physBinPath,
-                    sizeof(physBinPath)) != 0)
-    {
-        return continueTgtTraversal;
-    }
+    // Same as the earlier per lookup traversal, the first target in
+    // traversal order wins if a path shows up twice.
+    index->targets.try_emplace(
+        PhysBinPath(std::begin(physBinPath), std::end(physBinPath)),
+        IndexedTarget{target});
+
+    return continueTgtTraversal;
+}
+
+/**
+ * @brief Read the callout attributes of an indexed target
+ *
+ * Incase of any attribute read failure, the data is left with the
+ * default value.
+ *
+ * @param[in,out] entry indexed target
+ */
+static void readTgtReqAttrs(IndexedTarget& entry)
+{
+    using namespace openpower::phal::pdbg;
 
-    // Found Target, now collect the required attributes associated to the
-    // target. Incase of any attribute read failure, initialize the data with
-    // default value.
+    auto* target = entry.target;
     try
     {
         // Get location code information
-        openpower::phal::pdbg::getLocationCode(target,
-                                               targetInfo->locationCode);
+        openpower::phal::pdbg::getLocationCode(target, entry.locationCode);
     }
     catch (const std::exception& e)
     {
@@ -126,7 +176,7 @@ int pdbgCallbackToGetTgtReqAttrsVal(struct pdbg_target* target,
                             .c_str());
     }
 
-    if (DT_GET_PROP(ATTR_PHYS_DEV_PATH, target, targetInfo->physDevPath))
+    if (DT_GET_PROP(ATTR_PHYS_DEV_PATH, target, entry.physDevPath))
     {
         log<level::ERR>(
             std::format("Could not read({}) PHYS_DEV_PATH attribute",
@@ -134,24 +184,23 @@ int pdbgCallbackToGetTgtReqAttrsVal(struct pdbg_target* target,
                 .c_str());
     }
 
-    if (DT_GET_PROP(ATTR_MRU_ID, target, targetInfo->mruId))
+    if (DT_GET_PROP(ATTR_MRU_ID, target, entry.mruId))
     {
         log<level::ERR>(std::format("Could not read({}) ATTR_MRU_ID attribute",
                                     pdbg_target_path(target))
                             .c_str());
     }
 
-    return requireAttrFound;
+    entry.attrsRead = true;
 }
 
 /**
  * @brief Used to get target info (attributes data)
  *
  * To get target required attributes value using another attribute value
- * ("PHYS_BIN_PATH" which is present in same target attributes list) by using
- * "ipdbg_target_traverse" api because, here we have attribute value only and
- * doesn't have respective device tree target info to get required attributes
- * values from it attributes list.
+ * ("PHYS_BIN_PATH" which is present in same target attributes list).
+ * The device tree target info is not known here, so the target is found
+ * through the PHYS_BIN_PATH index, which is built on the first call.
  *
  * @param[in] physBinPath to pass PHYS_BIN_PATH value
  * @param[out] targetInfo to pas buufer to fill with required attributes
@@ -162,11 +211,19 @@ bool getTgtReqAttrsVal(const std::vector<uint8_t>& physBinPath,
                        TargetInfo& targetInfo)
 {
     std::memcpy(&targetInfo.physBinPath, physBinPath.data(),
-                sizeof(targetInfo.physBinPath));
+                std::min(physBinPath.size(), sizeof(targetInfo.physBinPath)));
 
-    int ret = pdbg_target_traverse(NULL, pdbgCallbackToGetTgtReqAttrsVal,
-                                   &targetInfo);
-    if (ret == 0)
+    std::lock_guard<std::mutex> guard(targetIndex.lock);
+    if (!targetIndex.built)
+    {
+        pdbg_target_traverse(NULL, pdbgCallbackToIndexTarget, &targetIndex);
+        targetIndex.built = true;
+    }
+
+    auto it = targetIndex.targets.find(
+        PhysBinPath(std::begin(targetInfo.physBinPath),
+                    std::end(targetInfo.physBinPath)));
+    if (it == targetIndex.targets.end())
     {
         std::string fmt;
         for (auto value : targetInfo.physBinPath)
@@ -180,10 +237,17 @@ bool getTgtReqAttrsVal(const std::vector<uint8_t>& physBinPath,
                             .c_str());
         return false;
     }
-    else if (ret == requireAttrNotFound)
+
+    auto& entry = it->second;
+    if (!entry.attrsRead)
     {
-        return false;
+        readTgtReqAttrs(entry);
     }
+    std::memcpy(&targetInfo.locationCode, entry.locationCode,
+                sizeof(targetInfo.locationCode));
+    std::memcpy(&targetInfo.physDevPath, entry.physDevPath,
+                sizeof(targetInfo.physDevPath));
+    targetInfo.mruId = entry.mruId;
 
     return true;
 }
@@ -197,76 +261,70 @@ namespace detail
 {
 using json = nlohmann::json;
 
-// keys need to be unique so using counter value to generate unique key
-static int counter = 0;
+// traces of a higher (less important) pdbg log level are not journaled
+static int journalLevel = PDBG_INFO;
+
+// crash persistent copy of the debug traces
+static std::unique_ptr<FlightRecorder> recorder;
 
-// list of debug traces
-static std::vector<std::pair<std::string, std::string>> traceLog;
+// number of traces of an unclean previous run added to its PEL
+constexpr uint32_t RECORDER_PEL_TRACE_COUNT = 32;
+
+// event of the PEL reporting an unclean previous run
+constexpr auto UNCLEAN_EXIT_EVENT = "org.open_power.PHAL.Info.UncleanExit";
 
 /**
- * @brief Process platform realted boot failure
+ * @brief Add debug trace to the trace buffer and journal
  *
- * @param[in] errInfo - error details
+ * @param[in] logLevel - pdbg log level of the trace
+ * @param[in] fmt - format for variable list arguments
+ * @param[in] ap - object of va_list
  */
-static void processPlatBootError(const ipl_error_info& errInfo);
-
-void processLogTraceCallback(void*, const char* fmt, va_list ap)
+static void addTrace(int logLevel, const char* fmt, va_list ap)
 {
     va_list vap;
     va_copy(vap, ap);
-    std::vector<char> logData(1 + std::vsnprintf(nullptr, 0, fmt, ap));
-    std::vsnprintf(logData.data(), logData.size(), fmt, vap);
+
+    // Threads without their own context share the process context
+    ErrorContext::current().withTraces([&](TraceBuffer& traceLog) {
+        bool complete = traceLog.add(fmt, ap);
+        if (recorder)
+        {
+            recorder->add(traceLog.last());
+        }
+
+        if (logLevel <= journalLevel)
+        {
+            if (complete)
+            {
+                log<level::INFO>(traceLog.last());
+            }
+            else
+            {
+                // Only the buffered copy is truncated
+                va_list sizeAp;
+                va_copy(sizeAp, vap);
+                std::vector<char> logData(
+                    1 + std::vsnprintf(nullptr, 0, fmt, sizeAp));
+                va_end(sizeAp);
+                std::vsnprintf(logData.data(), logData.size(), fmt, vap);
+                log<level::INFO>(logData.data());
+            }
+        }
+    });
     va_end(vap);
-    std::string logstr(logData.begin(), logData.end());
-
-    log<level::INFO>(logstr.c_str());
-
-    char timeBuf[80];
-    time_t t = time(0);
-    tm myTm{};
-    gmtime_r(&t, &myTm);
-    strftime(timeBuf, 80, "%Y-%m-%d %H:%M:%S", &myTm);
-
-    // key values need to be unique for PEL
-    // TODO #openbmc/dev/issues/1563
-    // If written to Json no need to worry about unique KEY
-    std::stringstream str;
-    str << std::setfill('0');
-    str << "LOG" << std::setw(3) << counter;
-    str << " " << timeBuf;
-    traceLog.emplace_back(std::make_pair(str.str(), std::move(logstr)));
-    counter++;
 }
 
 /**
- * @brief GET PEL priority from pHAL priority
- *
- * The pHAL callout priority is in different format than PEL format
- * so, this api is used to return current phal supported priority into
- * PEL expected format.
- *
- * @param[in] phalPriority used to pass phal priority format string
- *
- * @return pel priority format string else empty if failure
+ * @brief Process platform realted boot failure
  *
- * @note For "NONE" returning "L" (LOW)
+ * @param[in] errInfo - error details
  */
-static std::string getPelPriority(const std::string& phalPriority)
-{
-    const std::map<std::string, std::string> priorityMap = {
-        {"HIGH", "H"}, {"MEDIUM", "M"}, {"LOW", "L"}, {"NONE", "L"}};
-
-    auto it = priorityMap.find(phalPriority);
-    if (it == priorityMap.end())
-    {
-        log<level::ERR>(std::format("Unsupported phal priority({}) is given "
-                                    "to get pel priority format",
-                                    phalPriority)
-                            .c_str());
-        return "H";
-    }
+static void processPlatBootError(const ipl_error_info& errInfo);
 
-    return it->second;
+void processLogTraceCallback(void*, const char* fmt, va_list ap)
+{
+    addTrace(PDBG_INFO, fmt, ap);
 }
 
 /**
@@ -278,12 +336,10 @@ static std::string getPelPriority(const std::string& phalPriority)
  */
 void processNonFunctionalBootProc()
 {
-    json jsonCalloutDataList;
-    json jsonProcedCallout;
+    CalloutList callouts;
     // Add BMC code callout
-    jsonProcedCallout["Procedure"] = "BMC0001";
-    jsonProcedCallout["Priority"] = "H";
-    jsonCalloutDataList.emplace_back(std::move(jsonProcedCallout));
+    callouts.push_back({.priority = CalloutPriority::High,
+                        .procedure = "BMC0001"});
 
     // get primary processor
     struct pdbg_target* procTarget;
@@ -306,12 +362,10 @@ void processNonFunctionalBootProc()
             ATTR_LOCATION_CODE_Type locationCode = {'\0'};
             // Get location code information
             openpower::phal::pdbg::getLocationCode(procTarget, locationCode);
-            json jsonProcCallout;
-            jsonProcCallout["LocationCode"] = locationCode;
-            jsonProcCallout["Deconfigured"] = false;
-            jsonProcCallout["Guarded"] = false;
-            jsonProcCallout["Priority"] = "M";
-            jsonCalloutDataList.emplace_back(std::move(jsonProcCallout));
+            callouts.push_back({.priority = CalloutPriority::Medium,
+                                .locationCode = locationCode,
+                                .deconfigured = false,
+                                .guarded = false});
         }
         catch (const std::exception& e)
         {
@@ -320,16 +374,13 @@ void processNonFunctionalBootProc()
                                 .c_str());
         }
     }
-    // Adding collected phal logs into PEL additional data
+    // Adding collected phal logs into PEL
     FFDCData pelAdditionalData;
-    for_each(
-        traceLog.begin(), traceLog.end(),
-        [&pelAdditionalData](std::pair<std::string, std::string>& ele) -> void {
-        pelAdditionalData.emplace_back(ele.first, ele.second);
-    });
-    openpower::pel::createErrorPEL(
-        "org.open_power.PHAL.Error.NonFunctionalBootProc", jsonCalloutDataList,
-        pelAdditionalData, Severity::Error);
+    FFDCSections sections;
+    ErrorContext::current().appendTraces(pelAdditionalData, sections);
+    openpower::pel::queueErrorPEL(
+        "org.open_power.PHAL.Error.NonFunctionalBootProc", toJson(callouts),
+        pelAdditionalData, Severity::Error, sections);
     // reset trace log and exit
     reset();
 }
@@ -351,9 +402,9 @@ void processClockInfoErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
                         ffdc->message)
                 .c_str());
 
-        // To store callouts details in json format as per pel expectation.
-        json jsonCalloutDataList;
-        jsonCalloutDataList = json::array();
+        // To store callouts details, converted to json as per pel
+        // expectation when the PEL is created.
+        CalloutList callouts;
 
         // To store phal trace and other additional data about ffdc.
         FFDCData pelAdditionalData;
@@ -390,27 +441,21 @@ void processClockInfoErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
         // Adding CDG (Only deconfigure) targets details
         for_each(ffdc->hwp_errorinfo.cdg_targets.begin(),
                  ffdc->hwp_errorinfo.cdg_targets.end(),
-                 [&pelAdditionalData, &jsonCalloutDataList,
-                  clk_pos](const CDG_Target& cdg_tgt) -> void {
-            json jsonCalloutData;
-            std::string pelPriority = "L";
-            jsonCalloutData["Priority"] = pelPriority; // Not used
-            jsonCalloutData["SymbolicFRU"] = "REFCLK" + std::to_string(clk_pos);
-            jsonCalloutData["Deconfigured"] = cdg_tgt.deconfigure;
-            jsonCalloutData["EntityPath"] = cdg_tgt.target_entity_path;
-            jsonCalloutDataList.emplace_back(jsonCalloutData);
+                 [&callouts, clk_pos](const CDG_Target& cdg_tgt) -> void {
+            callouts.push_back(
+                {.priority = CalloutPriority::Low, // Not used
+                 .symbolicFRU = "REFCLK" + std::to_string(clk_pos),
+                 .deconfigured = cdg_tgt.deconfigure,
+                 .entityPath = cdg_tgt.target_entity_path});
         });
 
-        // Adding collected phal logs into PEL additional data
-        for_each(traceLog.begin(), traceLog.end(),
-                 [&pelAdditionalData](
-                     std::pair<std::string, std::string>& ele) -> void {
-            pelAdditionalData.emplace_back(ele.first, ele.second);
-        });
+        // Adding collected phal logs into PEL
+        FFDCSections sections;
+        ErrorContext::current().appendTraces(pelAdditionalData, sections);
 
-        openpower::pel::createErrorPEL("org.open_power.PHAL.Error.SpareClock",
-                                       jsonCalloutDataList, pelAdditionalData,
-                                       Severity::Informational);
+        openpower::pel::queueErrorPEL("org.open_power.PHAL.Error.SpareClock",
+                                      toJson(callouts), pelAdditionalData,
+                                      Severity::Informational, sections);
     }
     catch (const std::exception& ex)
     {
@@ -454,7 +499,7 @@ void processIplErrorCallback(const ipl_error_info& errInfo)
             processGuardPartitionAccessError();
             break;
         default:
-            createPEL("org.open_power.PHAL.Error.Boot");
+            queuePEL("org.open_power.PHAL.Error.Boot");
             // reset trace log and exit
             reset();
             break;
@@ -464,26 +509,20 @@ void processIplErrorCallback(const ipl_error_info& errInfo)
 /**
  * @brief addPlanarCallout
  *
- * This function will add a json for planar callout in the input json list.
- * The caller can pass this json list into createErrorPEL to apply the callout.
+ * This function will add a planar callout in the input callout list.
  *
- * @param[in,out] jsonCalloutDataList - json list where callout json will be
- *                  emplaced
- * @param[in] priority - string indicating priority.
+ * @param[in,out] callouts - callout list where the callout will be added
+ * @param[in] priority - callout priority
  */
-static void addPlanarCallout(json& jsonCalloutDataList,
-                             const std::string& priority)
+static void addPlanarCallout(CalloutList& callouts, CalloutPriority priority)
 {
-    json jsonCalloutData;
-
     // Inventory path for planar
-    jsonCalloutData["InventoryPath"] =
-        "/xyz/openbmc_project/inventory/system/chassis/motherboard";
-    jsonCalloutData["Deconfigured"] = false;
-    jsonCalloutData["Guarded"] = false;
-    jsonCalloutData["Priority"] = priority;
-
-    jsonCalloutDataList.emplace_back(jsonCalloutData);
+    callouts.push_back(
+        {.priority = priority,
+         .inventoryPath =
+             "/xyz/openbmc_project/inventory/system/chassis/motherboard",
+         .deconfigured = false,
+         .guarded = false});
 }
 
 /**
@@ -530,16 +569,13 @@ void processPoweroffError(FFDC* ffdc, const std::string& ffdc_prefix)
                     .c_str());
         }
 
-        // Adding collected phal logs into PEL additional data
-        for_each(traceLog.begin(), traceLog.end(),
-                 [&pelAdditionalData](
-                     std::pair<std::string, std::string>& ele) -> void {
-            pelAdditionalData.emplace_back(ele.first, ele.second);
-        });
+        // Adding collected phal logs into PEL
+        FFDCSections sections;
+        ErrorContext::current().appendTraces(pelAdditionalData, sections);
 
-        openpower::pel::createErrorPEL("org.open_power.PHAL.Error.Boot", {},
-                                       pelAdditionalData,
-                                       Severity::Informational);
+        openpower::pel::queueErrorPEL("org.open_power.PHAL.Error.Boot", {},
+                                      pelAdditionalData,
+                                      Severity::Informational, sections);
     }
     catch (const std::exception& ex)
     {
@@ -564,9 +600,9 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
             processClockInfoErrorHelper(ffdc, ffdc_prefix);
             return;
         }
-        // To store callouts details in json format as per pel expectation.
-        json jsonCalloutDataList;
-        jsonCalloutDataList = json::array();
+        // To store callouts details, converted to json as per pel
+        // expectation when the PEL is created.
+        CalloutList callouts;
 
         // To store phal trace and other additional data about ffdc.
         FFDCData pelAdditionalData;
@@ -596,7 +632,7 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
             int calloutCount = 0;
             for_each(ffdc->hwp_errorinfo.hwcallouts.begin(),
                      ffdc->hwp_errorinfo.hwcallouts.end(),
-                     [&pelAdditionalData, &calloutCount, &jsonCalloutDataList,
+                     [&pelAdditionalData, &calloutCount, &callouts,
                       &ffdc_prefix](const HWCallout& hwCallout) -> void {
                 calloutCount++;
                 std::stringstream keyPrefix;
@@ -640,12 +676,10 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
                     std::string(keyPrefix.str()).append("CALLOUT_PLANAR"),
                     (hwCallout.isPlanarCallout == true ? "true" : "false"));
 
-                std::string pelPriority =
-                    getPelPriority(hwCallout.callout_priority);
-
                 if (hwCallout.isPlanarCallout)
                 {
-                    addPlanarCallout(jsonCalloutDataList, pelPriority);
+                    addPlanarCallout(callouts, getPelPriority(
+                                                   hwCallout.callout_priority));
                 }
             });
 
@@ -653,7 +687,7 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
             calloutCount = 0;
             for_each(ffdc->hwp_errorinfo.cdg_targets.begin(),
                      ffdc->hwp_errorinfo.cdg_targets.end(),
-                     [&pelAdditionalData, &calloutCount, &jsonCalloutDataList,
+                     [&pelAdditionalData, &calloutCount, &callouts,
                       &ffdc_prefix](const CDG_Target& cdg_tgt) -> void {
                 calloutCount++;
                 std::stringstream keyPrefix;
@@ -693,31 +727,21 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
                     std::string(keyPrefix.str()).append("GUARD_TYPE"),
                     cdg_tgt.guard_type);
 
-                json jsonCalloutData;
-                jsonCalloutData["LocationCode"] = locationCode;
-                std::string pelPriority =
-                    getPelPriority(cdg_tgt.callout_priority);
-                jsonCalloutData["Priority"] = pelPriority;
-
-                if (targetInfo.mruId != 0)
-                {
-                    jsonCalloutData["MRUs"] = json::array({
-                        {{"ID", targetInfo.mruId}, {"Priority", pelPriority}},
-                    });
-                }
-                jsonCalloutData["Deconfigured"] = cdg_tgt.deconfigure;
-                jsonCalloutData["Guarded"] = cdg_tgt.guard;
-                jsonCalloutData["GuardType"] = cdg_tgt.guard_type;
-                jsonCalloutData["EntityPath"] = cdg_tgt.target_entity_path;
-
-                jsonCalloutDataList.emplace_back(jsonCalloutData);
+                callouts.push_back(
+                    {.priority = getPelPriority(cdg_tgt.callout_priority),
+                     .locationCode = locationCode,
+                     .mruId = targetInfo.mruId,
+                     .deconfigured = cdg_tgt.deconfigure,
+                     .guarded = cdg_tgt.guard,
+                     .guardType = cdg_tgt.guard_type,
+                     .entityPath = cdg_tgt.target_entity_path});
             });
             // Adding procedure callout
             calloutCount = 0;
             for_each(
                 ffdc->hwp_errorinfo.procedures_callout.begin(),
                 ffdc->hwp_errorinfo.procedures_callout.end(),
-                [&pelAdditionalData, &calloutCount, &jsonCalloutDataList,
+                [&pelAdditionalData, &calloutCount, &callouts,
                  &ffdc_prefix](const ProcedureCallout& procCallout) -> void {
                 calloutCount++;
                 std::stringstream keyPrefix;
@@ -732,12 +756,9 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
                     std::string(keyPrefix.str()).append("MAINT_PROCEDURE"),
                     procCallout.proc_callout);
 
-                json jsonCalloutData;
-                jsonCalloutData["Procedure"] = procCallout.proc_callout;
-                std::string pelPriority =
-                    getPelPriority(procCallout.callout_priority);
-                jsonCalloutData["Priority"] = pelPriority;
-                jsonCalloutDataList.emplace_back(jsonCalloutData);
+                callouts.push_back(
+                    {.priority = getPelPriority(procCallout.callout_priority),
+                     .procedure = procCallout.proc_callout});
             });
         }
         else if ((ffdc->ffdc_type != FFDC_TYPE_NONE) &&
@@ -750,38 +771,15 @@ void processBootErrorHelper(FFDC* ffdc, const std::string& ffdc_prefix)
                     .c_str());
         }
 
-        // Adding collected phal logs into PEL additional data
-        for_each(traceLog.begin(), traceLog.end(),
-                 [&pelAdditionalData](
-                     std::pair<std::string, std::string>& ele) -> void {
-            pelAdditionalData.emplace_back(ele.first, ele.second);
-        });
-
-        // TODO: #ibm-openbmc/dev/issues/2595 : Once enabled this support,
-        // callout details is not required to sort in H,M and L orders which
-        // are expected by pel because, pel will take care for sorting callouts
-        // based on priority so, now adding support to send callout in order
-        // i.e High -> Medium -> Low.
-        std::sort(jsonCalloutDataList.begin(), jsonCalloutDataList.end(),
-                  [](const json& aEle, const json& bEle) -> bool {
-            // Considering b element having higher priority than a element
-            // or Both element will be same priorty (to keep same order
-            // which are given by phal when two callouts are having same
-            // priority)
-            if (((aEle["Priority"] == "M") && (bEle["Priority"] == "H")) ||
-                ((aEle["Priority"] == "L") &&
-                 ((bEle["Priority"] == "H") || (bEle["Priority"] == "M"))) ||
-                (aEle["Priority"] == bEle["Priority"]))
-            {
-                return false;
-            }
+        // Adding collected phal logs into PEL
+        FFDCSections sections;
+        ErrorContext::current().appendTraces(pelAdditionalData, sections);
 
-            // Considering a element having higher priority than b element
-            return true;
-        });
-        openpower::pel::createErrorPEL("org.open_power.PHAL.Error.Boot",
-                                       jsonCalloutDataList, pelAdditionalData,
-                                       Severity::Error);
+        // Adding callouts in the High -> Medium -> Low order pel expects
+        sortByPriority(callouts);
+        openpower::pel::queueErrorPEL("org.open_power.PHAL.Error.Boot",
+                                      toJson(callouts), pelAdditionalData,
+                                      Severity::Error, sections);
     }
     catch (const std::exception& ex)
     {
@@ -848,71 +846,83 @@ void processBootError(bool status)
     }
 }
 
-void processSbeBootError()
-{
-    log<level::INFO>("processSbeBootError : Entered ");
+/**
+ * Expected duration of the SBE FFDC capture of all the processors, the
+ * slower ones are only traced. A hung capture is ended by the SBE FIFO
+ * driver timeout.
+ */
+constexpr auto SBE_FFDC_CAPTURE_EXPECTED_TIME = std::chrono::seconds(90);
 
-    using namespace openpower::phal::sbe;
+/**
+ * @brief SBE FFDC captured from one processor
+ */
+struct SbeFFDC
+{
+    /** SBE error object */
+    sbeError_t sbeError;
 
-    // To store phal trace and other additional data about ffdc.
-    FFDCData pelAdditionalData;
+    /** Set if the FFDC could not be collected */
+    bool captureFailed = false;
 
-    // Adding collected phal logs into PEL additional data
-    for_each(
-        traceLog.begin(), traceLog.end(),
-        [&pelAdditionalData](std::pair<std::string, std::string>& ele) -> void {
-        pelAdditionalData.emplace_back(ele.first, ele.second);
-    });
+    /** Debug trace summary of the capture */
+    FFDCData traces;
 
-    // reset the trace log and counter
-    reset();
+    /** Debug traces of the capture */
+    FFDCSections traceSections;
+};
 
-    // get primary processor to collect FFDC/Dump information.
-    struct pdbg_target* procTarget;
-    pdbg_for_each_class_target("proc", procTarget)
-    {
-        if (openpower::phal::isPrimaryProc(procTarget))
-            break;
-        procTarget = nullptr;
-    }
-    // check valid primary processor is available
-    if (procTarget == nullptr)
-    {
-        log<level::ERR>("processSbeBootError: fail to get primary processor");
-        // Add BMC code callout and create PEL
-        json jsonCalloutDataList;
-        jsonCalloutDataList = json::array();
-        json jsonCalloutData;
-        jsonCalloutData["Procedure"] = "BMC0001";
-        jsonCalloutData["Priority"] = "H";
-        jsonCalloutDataList.emplace_back(jsonCalloutData);
-        openpower::pel::createErrorPEL(
-            "org.open_power.Processor.Error.SbeBootFailure",
-            jsonCalloutDataList, {}, Severity::Error);
-        return;
-    }
-    // SBE error object.
-    sbeError_t sbeError;
-    bool dumpIsRequired = false;
+/**
+ * @brief Capture SBE FFDC from a processor
+ *
+ * The capture runs in its own error context, so captures running
+ * concurrently on several processors keep their traces apart.
+ *
+ * @param[in] procTarget - pdbg processor target
+ *
+ * @return captured FFDC
+ */
+static SbeFFDC captureSbeFFDC(struct pdbg_target* procTarget)
+{
+    using namespace openpower::phal::sbe;
 
+    ScopedErrorContext context;
+    SbeFFDC ffdc;
     try
     {
-        // Capture FFDC information on primary processor
-        sbeError = captureFFDC(procTarget);
+        // Capture FFDC information on processor
+        ffdc.sbeError = captureFFDC(procTarget);
     }
     catch (const phalError_t& phalError)
     {
-        // Fail to collect FFDC information , trigger Dump
-        log<level::ERR>(
-            std::format("captureFFDC: Exception({})", phalError.what())
-                .c_str());
-        dumpIsRequired = true;
+        log<level::ERR>(std::format("captureFFDC: Exception({}) on proc({})",
+                                    phalError.what(),
+                                    pdbg_target_index(procTarget))
+                            .c_str());
+        ffdc.captureFailed = true;
     }
+    context.get().appendTraces(ffdc.traces, ffdc.traceSections);
+    return ffdc;
+}
 
+/**
+ * @brief Create SBE boot error PEL of a processor, request dump if needed
+ *
+ * @param[in] procTarget - pdbg processor target
+ * @param[in] ffdc - FFDC captured from the processor
+ * @param[in] pelAdditionalData - additional data to add to the PEL
+ * @param[in] sections - binary FFDC sections to add to the PEL
+ */
+static void createSbeBootErrorPEL(struct pdbg_target* procTarget,
+                                  const SbeFFDC& ffdc,
+                                  FFDCData pelAdditionalData,
+                                  const FFDCSections& sections)
+{
     std::string event;
+    bool dumpIsRequired = false;
 
-    if ((sbeError.errType() == SBE_FFDC_NO_DATA) ||
-        (sbeError.errType() == SBE_CMD_TIMEOUT) || (dumpIsRequired))
+    // Fail to collect FFDC information, trigger Dump
+    if ((ffdc.sbeError.errType() == SBE_FFDC_NO_DATA) ||
+        (ffdc.sbeError.errType() == SBE_CMD_TIMEOUT) || (ffdc.captureFailed))
     {
         event = "org.open_power.Processor.Error.SbeBootTimeout";
         dumpIsRequired = true;
@@ -925,10 +935,19 @@ void processSbeBootError()
     uint32_t index = pdbg_target_index(procTarget);
     pelAdditionalData.emplace_back("SRC6", std::to_string(index << 16));
     // Create SBE Error with FFDC data.
-    auto logId = createSbeErrorPEL(event, sbeError, pelAdditionalData,
-                                   procTarget);
+    auto logId = createSbeErrorPEL(event, ffdc.sbeError, pelAdditionalData,
+                                   procTarget, Severity::Error, sections);
 
-    if (dumpIsRequired)
+    if (dumpIsRequired && (logId == 0))
+    {
+        // Duplicate dropped by the rate limit, the first occurrence
+        // already requested the dump.
+        log<level::INFO>(
+            std::format("Skipping SBE dump of proc({}), PEL was dropped",
+                        index)
+                .c_str());
+    }
+    else if (dumpIsRequired)
     {
         using namespace openpower::phal::dump;
         DumpParameters dumpParameters = {logId, index, SBE_DUMP_TIMEOUT,
@@ -946,31 +965,267 @@ void processSbeBootError()
     }
 }
 
+/**
+ * @brief Capture SBE FFDC from all the functional processors concurrently
+ *
+ * The PEL of the primary processor is created as for a single processor
+ * capture, with the boot traces. Secondary processors only get a PEL,
+ * with their capture traces, if their SBE reported an error or if the
+ * capture failed, the latter as an SBE boot timeout with a dump request.
+ *
+ * @param[in] primaryProc - pdbg primary processor target
+ * @param[in] pelAdditionalData - additional data for the primary PEL
+ * @param[in] sections - binary FFDC sections for the primary PEL
+ */
+static void processAllProcsSbeBootError(struct pdbg_target* primaryProc,
+                                        const FFDCData& pelAdditionalData,
+                                        const FFDCSections& sections)
+{
+    std::vector<struct pdbg_target*> procs;
+    struct pdbg_target* procTarget;
+    pdbg_for_each_class_target("proc", procTarget)
+    {
+        ATTR_HWAS_STATE_Type hwasState;
+        if (DT_GET_PROP(ATTR_HWAS_STATE, procTarget, hwasState))
+        {
+            log<level::ERR>(
+                std::format("Could not read({}) HWAS_STATE attribute",
+                            pdbg_target_path(procTarget))
+                    .c_str());
+            continue;
+        }
+        if (hwasState.functional || (procTarget == primaryProc))
+        {
+            procs.push_back(procTarget);
+        }
+    }
+
+    // The processors share FSI ancestors, probe them before the captures
+    // access them concurrently.
+    openpower::phal::probeProcTargets(procs);
+
+    auto results = util::runParallel(procs, captureSbeFFDC,
+                                     SBE_FFDC_CAPTURE_EXPECTED_TIME);
+
+    // Create the PELs and request the dumps once all the captures ended
+    for (size_t i = 0; i < procs.size(); i++)
+    {
+        auto& result = results[i];
+        auto index = pdbg_target_index(procs[i]);
+
+        if (result.timedOut)
+        {
+            log<level::ERR>(
+                std::format("SBE FFDC capture on proc({}) took longer than "
+                            "the {} seconds expected",
+                            index, SBE_FFDC_CAPTURE_EXPECTED_TIME.count())
+                    .c_str());
+        }
+
+        if (procs[i] == primaryProc)
+        {
+            SbeFFDC ffdc;
+            if (result.value)
+            {
+                ffdc = std::move(*result.value);
+            }
+            else
+            {
+                log<level::ERR>(
+                    std::format("SBE FFDC capture failed on primary proc({})",
+                                index)
+                        .c_str());
+                ffdc.captureFailed = true;
+            }
+            createSbeBootErrorPEL(procs[i], ffdc, pelAdditionalData,
+                                  sections);
+            continue;
+        }
+
+        if (!result.value)
+        {
+            // Unreachable SBE, SbeBootTimeout PEL with an SBE dump request
+            log<level::ERR>(
+                std::format("SBE FFDC capture failed on proc({})", index)
+                    .c_str());
+            SbeFFDC ffdc;
+            ffdc.captureFailed = true;
+            createSbeBootErrorPEL(procs[i], ffdc, {}, {});
+            continue;
+        }
+        if (!result.value->captureFailed &&
+            (result.value->sbeError.errType() == SBE_FFDC_NO_DATA))
+        {
+            // Nothing reported by this SBE
+            continue;
+        }
+        createSbeBootErrorPEL(procs[i], *result.value, result.value->traces,
+                              result.value->traceSections);
+    }
+}
+
+void processSbeBootError()
+{
+    log<level::INFO>("processSbeBootError : Entered ");
+
+    // To store phal trace and other additional data about ffdc.
+    FFDCData pelAdditionalData;
+    FFDCSections sections;
+
+    // Adding collected phal logs into PEL
+    ErrorContext::current().appendTraces(pelAdditionalData, sections);
+
+    // reset the trace log
+    reset();
+
+    // get primary processor to collect FFDC/Dump information.
+    struct pdbg_target* procTarget;
+    pdbg_for_each_class_target("proc", procTarget)
+    {
+        if (openpower::phal::isPrimaryProc(procTarget))
+            break;
+        procTarget = nullptr;
+    }
+    // check valid primary processor is available
+    if (procTarget == nullptr)
+    {
+        log<level::ERR>("processSbeBootError: fail to get primary processor");
+        // Add BMC code callout and create PEL
+        CalloutList callouts{{.priority = CalloutPriority::High,
+                              .procedure = "BMC0001"}};
+        openpower::pel::queueErrorPEL(
+            "org.open_power.Processor.Error.SbeBootFailure", toJson(callouts),
+            {}, Severity::Error);
+        return;
+    }
+
+    if (SBE_FFDC_ALL_PROCS)
+    {
+        processAllProcsSbeBootError(procTarget, pelAdditionalData, sections);
+        return;
+    }
+
+    // Capture FFDC information on primary processor
+    auto ffdc = captureSbeFFDC(procTarget);
+    createSbeBootErrorPEL(procTarget, ffdc, pelAdditionalData, sections);
+}
+
 void processGuardPartitionAccessError()
 {
-    // Adding collected phal logs into PEL additional data
+    // Adding collected phal logs into PEL
     FFDCData pelAdditionalData;
+    FFDCSections sections;
 
-    for_each(
-        traceLog.begin(), traceLog.end(),
-        [&pelAdditionalData](std::pair<std::string, std::string>& ele) -> void {
-        pelAdditionalData.emplace_back(ele.first, ele.second);
-    });
+    ErrorContext::current().appendTraces(pelAdditionalData, sections);
 
-    openpower::pel::createPEL("org.open_power.PHAL.Error.GuardPartitionAccess",
-                              pelAdditionalData);
+    openpower::pel::queuePEL("org.open_power.PHAL.Error.GuardPartitionAccess",
+                             pelAdditionalData, Severity::Error, sections);
 }
 
 void reset()
 {
-    // reset the trace log and counter
-    traceLog.clear();
-    counter = 0;
+    // reset the trace log of the current operation
+    ErrorContext::current().clearTraces();
 }
 
-void pDBGLogTraceCallbackHelper(int, const char* fmt, va_list ap)
+void pDBGLogTraceCallbackHelper(int logLevel, const char* fmt, va_list ap)
 {
-    processLogTraceCallback(NULL, fmt, ap);
+    addTrace(logLevel, fmt, ap);
+}
+
+/**
+ * @brief Create a PEL with the last traces of an unclean previous run
+ *
+ * @param[in] data - flight recorder content of the previous run
+ */
+static void createUncleanExitPEL(const RecorderData& data)
+{
+    FFDCData pelAdditionalData;
+    pelAdditionalData.emplace_back(
+        "REASON_FOR_PEL",
+        std::format("Previous PHAL procedure (pid {}) did not exit cleanly",
+                    data.header.pid));
+
+    auto first = data.traces.begin();
+    if (data.traces.size() > RECORDER_PEL_TRACE_COUNT)
+    {
+        first = data.traces.end() - RECORDER_PEL_TRACE_COUNT;
+    }
+    FFDCSection section(FFDCSectionType::Traces);
+    for (auto it = first; it != data.traces.end(); ++it)
+    {
+        const auto& [seq, timestamp, message] = *it;
+        section.addTrace(seq, timestamp, message);
+    }
+    pelAdditionalData.emplace_back("LOG_COUNT",
+                                   std::to_string(section.count()));
+
+    openpower::pel::queuePEL(UNCLEAN_EXIT_EVENT, pelAdditionalData,
+                             Severity::Informational, {std::move(section)});
+}
+
+/**
+ * @brief Report unclean previous runs and start this run's flight recorder
+ *
+ * Recorder files of dead processes are removed once handled, a set dirty
+ * marker in one of them is reported in a PEL. Failures are only traced,
+ * the procedure runs without a flight recorder then.
+ */
+static void startFlightRecorder()
+{
+    namespace fs = std::filesystem;
+    if (recorder)
+    {
+        return;
+    }
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(PHAL_TRACE_DIR, ec))
+    {
+        try
+        {
+            auto data = readRecorderFile(entry.path());
+            // Same pid and start time, still running, e.g. a concurrent
+            // PHAL procedure. A reused pid has a later start time.
+            if (getProcessStartTime(data.header.pid) == data.header.startTime)
+            {
+                continue;
+            }
+            if (data.header.dirty)
+            {
+                createUncleanExitPEL(data);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            log<level::ERR>(std::format("Ignoring trace recorder file({}), "
+                                        "EXCEPTION({})",
+                                        entry.path().string(), e.what())
+                                .c_str());
+        }
+        fs::remove(entry.path(), ec);
+    }
+
+    try
+    {
+        recorder = std::make_unique<FlightRecorder>(PHAL_TRACE_DIR);
+        std::atexit([] {
+            if (recorder)
+            {
+                recorder->markClean();
+            }
+        });
+        // A forked child shares the mapping, it must neither add to nor
+        // clean the parent's recorder. The child's mapping is left as is.
+        pthread_atfork(nullptr, nullptr, [] { (void)recorder.release(); });
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            std::format("Trace flight recorder disabled, EXCEPTION({})",
+                        e.what())
+                .c_str());
+    }
 }
 } // namespace detail
 
@@ -1000,6 +1255,13 @@ void addBootErrorCallbacks()
     libekb_set_loglevel(getLogLevelFromEnv("LIBEKB_LOG", LIBEKB_LOG_IMP));
     ipl_set_loglevel(getLogLevelFromEnv("IPL_LOG", IPL_INFO));
 
+    // Traces are always kept for the PEL, only journal those up to this
+    // pdbg log level. libekb and libipl traces count as PDBG_INFO.
+    detail::journalLevel = getLogLevelFromEnv("PHAL_JOURNAL_LOG", PDBG_INFO);
+
+    // Keep a copy of the traces which survives a crash of this process
+    detail::startFlightRecorder();
+
     // add callback for debug traces
     pdbg_set_logfunc(detail::pDBGLogTraceCallbackHelper);
     libekb_set_logfunc(detail::processLogTraceCallback, NULL);
@@ -14,8 +14,8 @@ namespace detail
 /**
  * @brief Process debug traces
  *
- * Function adds debug traces to the list so that it will be added to the
- * PEL upon failure
+ * Function adds debug traces to the trace buffer so that it will be added
+ * to the PEL upon failure
  *
  * @param[in] private_data - pointer to private data, unused now
  * @param[in] fmt - format for variable list arguments
@@ -65,7 +65,7 @@ void processSbeBootError();
 void processGuardPartitionAccessError();
 
 /**
- * @brief Reset trace log list
+ * @brief Reset trace log list of the calling thread's error context
  */
 void reset();
 
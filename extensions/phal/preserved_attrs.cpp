@@ -0,0 +1,578 @@
+extern "C"
+{
+#include <libpdbg.h>
+}
+
+#include "extensions/phal/preserved_attrs.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+namespace openpower
+{
+namespace phal
+{
+namespace attrs
+{
+
+using namespace phosphor::logging;
+
+namespace
+{
+
+/** @brief Append fixed size values and blobs to a byte buffer */
+class Writer
+{
+  public:
+    explicit Writer(std::vector<uint8_t>& buffer) : buffer(buffer) {}
+
+    template <typename T>
+    void put(const T& value)
+    {
+        auto p = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+    void put(const void* data, size_t size)
+    {
+        auto p = static_cast<const uint8_t*>(data);
+        buffer.insert(buffer.end(), p, p + size);
+    }
+
+    void putString(const std::string& str)
+    {
+        if (str.size() > UINT16_MAX)
+        {
+            throw std::runtime_error("Preserved attribute string too long");
+        }
+        put(static_cast<uint16_t>(str.size()));
+        put(str.data(), str.size());
+    }
+
+  private:
+    std::vector<uint8_t>& buffer;
+};
+
+/** @brief Bounds checked reader over a byte buffer */
+class Reader
+{
+  public:
+    explicit Reader(std::span<const uint8_t> data) : data(data) {}
+
+    template <typename T>
+    T get()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::span<const uint8_t> take(size_t size)
+    {
+        if (size > data.size() - offset)
+        {
+            throw std::runtime_error("Preserved attribute data truncated");
+        }
+        auto span = data.subspan(offset, size);
+        offset += size;
+        return span;
+    }
+
+    std::string getString()
+    {
+        auto size = get<uint16_t>();
+        auto span = take(size);
+        return std::string(span.begin(), span.end());
+    }
+
+    bool done() const
+    {
+        return offset == data.size();
+    }
+
+  private:
+    std::span<const uint8_t> data;
+    size_t offset = 0;
+};
+
+/** @brief CRC-32 lookup table, reflected polynomial 0xEDB88320 */
+constexpr std::array<uint32_t, 256> crcTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < table.size(); i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+/** @brief pdbg traverse private data used to collect attributes */
+struct CollectData
+{
+    const std::vector<std::string>* attrNames;
+    const Values* baseline;
+    Container* container;
+    uint32_t unchanged;
+};
+
+int collectCallback(struct pdbg_target* target, void* priv)
+{
+    auto data = static_cast<CollectData*>(priv);
+    auto& container = *data->container;
+    bool targetAdded = false;
+
+    for (size_t id = 0; id < data->attrNames->size(); id++)
+    {
+        size_t size = 0;
+        auto value = static_cast<const uint8_t*>(pdbg_target_property(
+            target, data->attrNames->at(id).c_str(), &size));
+        if (value == nullptr)
+        {
+            continue;
+        }
+
+        // Skip the value if it still holds the baseline value
+        auto base = data->baseline->find(
+            {pdbg_target_path(target), data->attrNames->at(id)});
+        if ((base != data->baseline->end()) &&
+            std::equal(base->second.begin(), base->second.end(), value,
+                       value + size))
+        {
+            data->unchanged++;
+            continue;
+        }
+
+        if (!targetAdded)
+        {
+            container.targetPaths.emplace_back(pdbg_target_path(target));
+            targetAdded = true;
+        }
+
+        container.records.push_back(
+            {static_cast<uint16_t>(id),
+             static_cast<uint16_t>(container.targetPaths.size() - 1),
+             std::vector<uint8_t>(value, value + size)});
+    }
+
+    // continue traversal
+    return 0;
+}
+
+int mapTargetCallback(struct pdbg_target* target, void* priv)
+{
+    auto targets = static_cast<std::map<std::string, pdbg_target*>*>(priv);
+    targets->emplace(pdbg_target_path(target), target);
+
+    // continue traversal
+    return 0;
+}
+
+/** @brief Flattened devtree blob format definitions */
+namespace fdt
+{
+constexpr uint32_t MAGIC = 0xD00DFEED;
+constexpr uint32_t BEGIN_NODE = 0x1;
+constexpr uint32_t END_NODE = 0x2;
+constexpr uint32_t PROP = 0x3;
+constexpr uint32_t NOP = 0x4;
+constexpr uint32_t END = 0x9;
+
+/** @brief Read big endian 32 bit value with bounds check */
+uint32_t be32(std::span<const uint8_t> blob, size_t offset)
+{
+    if ((offset > blob.size()) || (blob.size() - offset < sizeof(uint32_t)))
+    {
+        throw std::runtime_error("Devtree blob truncated");
+    }
+    return (uint32_t(blob[offset]) << 24) | (uint32_t(blob[offset + 1]) << 16) |
+           (uint32_t(blob[offset + 2]) << 8) | uint32_t(blob[offset + 3]);
+}
+
+/** @brief Read null terminated string with bounds check */
+std::string_view cstr(std::span<const uint8_t> blob, size_t offset)
+{
+    if (offset >= blob.size())
+    {
+        throw std::runtime_error("Devtree blob string out of range");
+    }
+    auto begin = reinterpret_cast<const char*>(blob.data()) + offset;
+    auto end = static_cast<const char*>(
+        std::memchr(begin, '\0', blob.size() - offset));
+    if (end == nullptr)
+    {
+        throw std::runtime_error("Devtree blob string not terminated");
+    }
+    return std::string_view(begin, end - begin);
+}
+
+constexpr size_t align4(size_t offset)
+{
+    return (offset + 3) & ~size_t(3);
+}
+} // namespace fdt
+
+} // namespace
+
+uint32_t crc32(std::span<const uint8_t> data)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (auto byte : data)
+    {
+        crc = crcTable[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+std::vector<uint8_t> serialize(const Container& container)
+{
+    if ((container.attrNames.size() > UINT16_MAX) ||
+        (container.targetPaths.size() > UINT16_MAX))
+    {
+        throw std::runtime_error("Too many preserved attributes or targets");
+    }
+
+    std::vector<uint8_t> payload;
+    Writer writer(payload);
+
+    for (const auto& name : container.attrNames)
+    {
+        writer.putString(name);
+    }
+    for (const auto& path : container.targetPaths)
+    {
+        writer.putString(path);
+    }
+    for (const auto& record : container.records)
+    {
+        writer.put(record.attrId);
+        writer.put(record.targetId);
+        writer.put(static_cast<uint32_t>(record.value.size()));
+        writer.put(record.value.data(), record.value.size());
+    }
+
+    Header header{};
+    header.magic = CONTAINER_MAGIC;
+    header.version = CONTAINER_VERSION;
+    header.numAttrs = container.attrNames.size();
+    header.numTargets = container.targetPaths.size();
+    header.numRecords = container.records.size();
+    header.payloadSize = payload.size();
+    header.payloadCrc = crc32(payload);
+
+    std::vector<uint8_t> data;
+    data.reserve(sizeof(header) + payload.size());
+    Writer(data).put(header);
+    data.insert(data.end(), payload.begin(), payload.end());
+    return data;
+}
+
+Container deserialize(std::span<const uint8_t> data)
+{
+    Reader headerReader(data);
+    auto header = headerReader.get<Header>();
+
+    if (header.magic != CONTAINER_MAGIC)
+    {
+        throw std::runtime_error("Invalid preserved attribute magic");
+    }
+    if (header.version != CONTAINER_VERSION)
+    {
+        throw std::runtime_error(std::format(
+            "Unsupported preserved attribute version({})", header.version));
+    }
+    if (data.size() - sizeof(header) != header.payloadSize)
+    {
+        throw std::runtime_error(
+            std::format("Preserved attribute size mismatch, expected({}) "
+                        "actual({})",
+                        header.payloadSize, data.size() - sizeof(header)));
+    }
+
+    auto payload = data.subspan(sizeof(header));
+    if (crc32(payload) != header.payloadCrc)
+    {
+        throw std::runtime_error("Preserved attribute checksum mismatch");
+    }
+
+    Container container;
+    Reader reader(payload);
+
+    for (uint32_t i = 0; i < header.numAttrs; i++)
+    {
+        container.attrNames.emplace_back(reader.getString());
+    }
+    for (uint32_t i = 0; i < header.numTargets; i++)
+    {
+        container.targetPaths.emplace_back(reader.getString());
+    }
+    for (uint32_t i = 0; i < header.numRecords; i++)
+    {
+        Record record;
+        record.attrId = reader.get<uint16_t>();
+        record.targetId = reader.get<uint16_t>();
+        auto value = reader.take(reader.get<uint32_t>());
+        record.value.assign(value.begin(), value.end());
+
+        if ((record.attrId >= container.attrNames.size()) ||
+            (record.targetId >= container.targetPaths.size()))
+        {
+            throw std::runtime_error(
+                "Preserved attribute record index out of range");
+        }
+        container.records.emplace_back(std::move(record));
+    }
+
+    if (!reader.done())
+    {
+        throw std::runtime_error("Preserved attribute trailing data");
+    }
+    return container;
+}
+
+bool isContainerFile(const fs::path& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return in && (magic == CONTAINER_MAGIC);
+}
+
+void writeFile(const fs::path& file, const Container& container)
+{
+    auto data = serialize(container);
+
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+    {
+        std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(data.data()), data.size());
+        out.flush();
+        if (!out)
+        {
+            throw std::runtime_error(std::format(
+                "Failed to write preserved attribute file({})",
+                tmpFile.string()));
+        }
+    }
+    fs::rename(tmpFile, file);
+}
+
+Container readFile(const fs::path& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error(std::format(
+            "Failed to open preserved attribute file({})", file.string()));
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+    return deserialize(data);
+}
+
+std::vector<std::string> readAttrList(const fs::path& file)
+{
+    std::ifstream in(file);
+    if (!in)
+    {
+        throw std::runtime_error(std::format(
+            "Failed to open attribute list file({})", file.string()));
+    }
+
+    std::vector<std::string> attrNames;
+    for (std::string line; std::getline(in, line);)
+    {
+        // first token of the line is the attribute name
+        auto begin = line.find_first_not_of(" \t");
+        if ((begin == std::string::npos) || (line[begin] == '#'))
+        {
+            continue;
+        }
+        auto end = line.find_first_of(" \t", begin);
+        attrNames.emplace_back(line.substr(begin, end - begin));
+    }
+    return attrNames;
+}
+
+Values readDevtreeBlob(const fs::path& file,
+                       const std::vector<std::string>& attrNames)
+{
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error(
+            std::format("Failed to open devtree file({})", file.string()));
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+    std::span<const uint8_t> blob(data);
+
+    if (fdt::be32(blob, 0) != fdt::MAGIC)
+    {
+        throw std::runtime_error(
+            std::format("Invalid devtree blob({})", file.string()));
+    }
+    auto structOffset = fdt::be32(blob, 8);
+    auto stringsOffset = fdt::be32(blob, 12);
+
+    const std::set<std::string_view> names(attrNames.begin(),
+                                           attrNames.end());
+    Values values;
+    std::vector<std::string> paths;
+
+    for (size_t offset = structOffset;;)
+    {
+        auto token = fdt::be32(blob, offset);
+        offset += sizeof(uint32_t);
+
+        if (token == fdt::BEGIN_NODE)
+        {
+            auto name = fdt::cstr(blob, offset);
+            offset = fdt::align4(offset + name.size() + 1);
+
+            if (paths.empty())
+            {
+                paths.emplace_back("/");
+            }
+            else
+            {
+                auto path = paths.back();
+                if (path != "/")
+                {
+                    path += '/';
+                }
+                paths.emplace_back(path.append(name));
+            }
+        }
+        else if (token == fdt::END_NODE)
+        {
+            if (paths.empty())
+            {
+                throw std::runtime_error("Devtree blob node mismatch");
+            }
+            paths.pop_back();
+        }
+        else if (token == fdt::PROP)
+        {
+            auto len = fdt::be32(blob, offset);
+            auto nameOffset = fdt::be32(blob, offset + 4);
+            offset += 2 * sizeof(uint32_t);
+            if ((paths.empty()) || (len > blob.size() - offset))
+            {
+                throw std::runtime_error("Devtree blob property corrupted");
+            }
+
+            auto name = fdt::cstr(blob, stringsOffset + nameOffset);
+            if (names.contains(name))
+            {
+                values.emplace(std::make_pair(paths.back(), std::string(name)),
+                               std::vector<uint8_t>(blob.begin() + offset,
+                                                    blob.begin() + offset +
+                                                        len));
+            }
+            offset = fdt::align4(offset + len);
+        }
+        else if (token == fdt::END)
+        {
+            break;
+        }
+        else if (token != fdt::NOP)
+        {
+            throw std::runtime_error(
+                std::format("Devtree blob invalid token({})", token));
+        }
+    }
+    return values;
+}
+
+std::vector<std::string> changedAttrs(const Values& values,
+                                      const Values& baseline)
+{
+    std::set<std::string> changed;
+    for (const auto& [key, value] : values)
+    {
+        auto base = baseline.find(key);
+        if ((base == baseline.end()) || (base->second != value))
+        {
+            changed.insert(key.second);
+        }
+    }
+    return std::vector<std::string>(changed.begin(), changed.end());
+}
+
+Container collect(const std::vector<std::string>& attrNames,
+                  const Values& baseline)
+{
+    Container container;
+    container.attrNames = attrNames;
+
+    CollectData data{&attrNames, &baseline, &container, 0};
+    pdbg_target_traverse(nullptr, collectCallback, &data);
+
+    log<level::INFO>(std::format("Collected ({}) preserved attribute values "
+                                 "from ({}) targets, unchanged ({})",
+                                 container.records.size(),
+                                 container.targetPaths.size(), data.unchanged)
+                         .c_str());
+    return container;
+}
+
+uint32_t apply(const Container& container)
+{
+    std::map<std::string, pdbg_target*> targets;
+    pdbg_target_traverse(nullptr, mapTargetCallback, &targets);
+
+    uint32_t skipped = 0;
+    for (const auto& record : container.records)
+    {
+        const auto& name = container.attrNames[record.attrId];
+        const auto& path = container.targetPaths[record.targetId];
+
+        auto it = targets.find(path);
+        if (it == targets.end())
+        {
+            log<level::ERR>(
+                std::format("Preserved attribute({}) target({}) not found",
+                            name, path)
+                    .c_str());
+            skipped++;
+            continue;
+        }
+
+        // Attribute definition can change across firmware versions, only
+        // restore values which still match the current attribute size.
+        size_t size = 0;
+        if ((pdbg_target_property(it->second, name.c_str(), &size) ==
+             nullptr) ||
+            (size != record.value.size()) ||
+            !pdbg_target_set_property(it->second, name.c_str(),
+                                      record.value.data(), size))
+        {
+            log<level::ERR>(
+                std::format("Preserved attribute({}) restore failed on "
+                            "target({}) size({})",
+                            name, path, record.value.size())
+                    .c_str());
+            skipped++;
+        }
+    }
+    return skipped;
+}
+
+} // namespace attrs
+} // namespace phal
+} // namespace openpower
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace openpower
+{
+namespace phal
+{
+namespace attrs
+{
+
+namespace fs = std::filesystem;
+
+/**
+ * Preserved attribute container layout (host byte order)
+ *
+ *   Header
+ *   Attribute name table : numAttrs   x { uint16 len, char name[len] }
+ *   Target path table    : numTargets x { uint16 len, char path[len] }
+ *   Records              : numRecords x { uint16 attrId, uint16 targetId,
+ *                                         uint32 size, uint8 value[size] }
+ *
+ * payloadSize and payloadCrc cover everything after the header, so the
+ * whole file is validated before a single attribute is applied.
+ */
+constexpr uint32_t CONTAINER_MAGIC = 0x50415452; // "PATR"
+constexpr uint16_t CONTAINER_VERSION = 1;
+
+struct Header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t numAttrs;
+    uint32_t numTargets;
+    uint32_t numRecords;
+    uint32_t payloadSize;
+    uint32_t payloadCrc;
+};
+
+/** @brief One preserved attribute value of one target */
+struct Record
+{
+    uint16_t attrId;            // index into Container::attrNames
+    uint16_t targetId;          // index into Container::targetPaths
+    std::vector<uint8_t> value; // raw devtree property value
+};
+
+/** @brief In memory form of the preserved attribute container */
+struct Container
+{
+    std::vector<std::string> attrNames;
+    std::vector<std::string> targetPaths;
+    std::vector<Record> records;
+};
+
+/**
+ * @brief Attribute values read from a flattened devtree blob
+ *
+ * Keyed by target (node) path and attribute name.
+ */
+using Values = std::map<std::pair<std::string, std::string>,
+                        std::vector<uint8_t>>;
+
+/**
+ * @brief Compute CRC-32 (IEEE 802.3) of the given data
+ *
+ * @param[in] data - data to checksum
+ *
+ * @return crc value
+ */
+uint32_t crc32(std::span<const uint8_t> data);
+
+/**
+ * @brief Serialize container into binary format
+ *
+ * @param[in] container - container to serialize
+ *
+ * @return binary data
+ */
+std::vector<uint8_t> serialize(const Container& container);
+
+/**
+ * @brief Deserialize and validate binary container data
+ *
+ * Throws std::runtime_error if the data is truncated, corrupted or of
+ * an unsupported version.
+ *
+ * @param[in] data - binary data
+ *
+ * @return container
+ */
+Container deserialize(std::span<const uint8_t> data);
+
+/**
+ * @brief Check whether the file starts with the container magic
+ *
+ * @param[in] file - file to check
+ *
+ * @return true if file is in binary container format
+ */
+bool isContainerFile(const fs::path& file);
+
+/**
+ * @brief Write container to file
+ *
+ * The data is written to a temporary file in the same directory which is
+ * then renamed, so readers never observe a partially written container.
+ * Throws std::runtime_error on failure.
+ *
+ * @param[in] file - destination file
+ * @param[in] container - container to write
+ */
+void writeFile(const fs::path& file, const Container& container);
+
+/**
+ * @brief Read and validate container from file
+ *
+ * Throws std::runtime_error on failure.
+ *
+ * @param[in] file - container file
+ *
+ * @return container
+ */
+Container readFile(const fs::path& file);
+
+/**
+ * @brief Read attribute name list file
+ *
+ * One attribute name per line, empty and '#' comment lines are skipped.
+ * Throws std::runtime_error on failure.
+ *
+ * @param[in] file - attribute list file
+ *
+ * @return attribute names
+ */
+std::vector<std::string> readAttrList(const fs::path& file);
+
+/**
+ * @brief Read the given attributes from a flattened devtree blob file
+ *
+ * Used to compare against a devtree which is not the pdbg devtree of
+ * this process, like the RO devtree lid.
+ * Throws std::runtime_error on failure.
+ *
+ * @param[in] file - devtree blob file
+ * @param[in] attrNames - attributes to read
+ *
+ * @return attribute values
+ */
+Values readDevtreeBlob(const fs::path& file,
+                       const std::vector<std::string>& attrNames);
+
+/**
+ * @brief Get the attributes which differ between two devtree value sets
+ *
+ * An attribute is reported when any target holds a value which is not
+ * present, or not the same, in the baseline.
+ *
+ * @param[in] values - current attribute values
+ * @param[in] baseline - baseline attribute values
+ *
+ * @return names of the changed attributes, sorted
+ */
+std::vector<std::string> changedAttrs(const Values& values,
+                                      const Values& baseline);
+
+/**
+ * @brief Collect the given attributes from the pdbg device tree
+ *
+ * pdbg targets must be initialized by the caller. Values identical to
+ * the baseline value of the same target are skipped, so the container
+ * only holds the attributes which differ from the baseline.
+ *
+ * @param[in] attrNames - attributes to collect
+ * @param[in] baseline - baseline values, empty to collect all
+ *
+ * @return container with all the targets which hold the attributes
+ */
+Container collect(const std::vector<std::string>& attrNames,
+                  const Values& baseline = {});
+
+/**
+ * @brief Apply container attribute values to the pdbg device tree
+ *
+ * pdbg targets must be initialized by the caller. Records for unknown
+ * targets or attributes with a changed size are skipped and traced.
+ *
+ * @param[in] container - validated container
+ *
+ * @return number of records skipped
+ */
+uint32_t apply(const Container& container);
+
+} // namespace attrs
+} // namespace phal
+} // namespace openpower
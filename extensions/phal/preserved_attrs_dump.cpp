@@ -0,0 +1,48 @@
+#include "config.h"
+
+#include "extensions/phal/preserved_attrs.hpp"
+
+#include <format>
+#include <iostream>
+
+/**
+ * @brief Debug tool to print the preserved attribute container in text form
+ *
+ * Usage: phal-preserved-attrs-dump [file]
+ * Default file is the devtree export copy file.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::phal;
+
+    const char* file = (argc > 1) ? argv[1] : DEVTREE_EXP_FILE;
+
+    try
+    {
+        auto container = attrs::readFile(file);
+
+        std::cout << std::format("# {} : attributes({}) targets({}) "
+                                 "records({})\n",
+                                 file, container.attrNames.size(),
+                                 container.targetPaths.size(),
+                                 container.records.size());
+
+        for (const auto& record : container.records)
+        {
+            std::string value;
+            for (auto byte : record.value)
+            {
+                value += std::format("{:02x}", byte);
+            }
+            std::cout << std::format(
+                "{} {} 0x{}\n", container.targetPaths[record.targetId],
+                container.attrNames[record.attrId], value);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << std::format("Failed to read ({}): {}\n", file, e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include "trace_buffer.hpp"
+
+#include <cstdio>
+#include <format>
+
+namespace openpower
+{
+namespace pel
+{
+
+std::string getTraceKey(uint32_t seq, time_t timestamp)
+{
+    char timeBuf[32];
+    tm myTm{};
+    gmtime_r(&timestamp, &myTm);
+    strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", &myTm);
+
+    // key values need to be unique for PEL
+    return std::format("LOG{:03} {}", seq, timeBuf);
+}
+
+bool TraceBuffer::add(const char* fmt, va_list ap)
+{
+    auto& record = records[total % TRACE_RECORD_COUNT];
+    record.timestamp = time(nullptr);
+    total++;
+
+    int len = std::vsnprintf(record.message, sizeof(record.message), fmt, ap);
+    if (len < 0)
+    {
+        record.message[0] = '\0';
+        return true;
+    }
+    return static_cast<size_t>(len) < sizeof(record.message);
+}
+
+void TraceBuffer::clear()
+{
+    total = 0;
+}
+
+void TraceBuffer::appendTo(FFDCData& ffdcData, FFDCSections& sections) const
+{
+    uint32_t first = 0;
+    if (total > TRACE_RECORD_COUNT)
+    {
+        first = total - TRACE_RECORD_COUNT;
+    }
+
+    // Keep the newest traces which fit in the section
+    uint32_t start = total;
+    size_t size = FFDC_SECTION_HEADER_SIZE;
+    while (start > first)
+    {
+        size += FFDCSection::getTraceEntrySize(
+            records[(start - 1) % TRACE_RECORD_COUNT].message);
+        if (size > FFDC_SECTION_MAX_SIZE)
+        {
+            break;
+        }
+        start--;
+    }
+
+    ffdcData.emplace_back("LOG_COUNT", std::to_string(total - start));
+    if (start > 0)
+    {
+        ffdcData.emplace_back("LOG_DROPPED", std::to_string(start));
+    }
+    if (total == 0)
+    {
+        return;
+    }
+    ffdcData.emplace_back("LOG_LAST", last());
+
+    FFDCSection section(FFDCSectionType::Traces);
+    for (uint32_t seq = start; seq < total; seq++)
+    {
+        const auto& record = records[seq % TRACE_RECORD_COUNT];
+        section.addTrace(seq, record.timestamp, record.message);
+    }
+    sections.push_back(std::move(section));
+}
+
+const char* TraceBuffer::last() const
+{
+    if (total == 0)
+    {
+        return "";
+    }
+    return records[(total - 1) % TRACE_RECORD_COUNT].message;
+}
+
+} // namespace pel
+} // namespace openpower
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ffdc_section.hpp"
+
+#include <array>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace openpower
+{
+namespace pel
+{
+
+using FFDCData = std::vector<std::pair<std::string, std::string>>;
+
+/** Maximum trace message length kept, longer messages are truncated */
+constexpr size_t TRACE_MSG_SIZE = 256;
+
+/** Number of traces kept, older traces are overwritten */
+constexpr size_t TRACE_RECORD_COUNT = 512;
+
+/**
+ * @brief Build the PEL additional data key of a trace
+ *
+ * @param[in] seq - trace sequence number
+ * @param[in] timestamp - trace time
+ *
+ * @return "LOG<seq> <UTC time>" key
+ */
+std::string getTraceKey(uint32_t seq, time_t timestamp);
+
+/**
+ * @class TraceBuffer
+ * @brief Fixed size ring buffer of formatted debug traces
+ *
+ * The records live in a preallocated arena, so adding a trace formats
+ * the message once in place and never allocates. Only the raw timestamp
+ * is kept, the PEL keys are built when the traces are added to a PEL.
+ */
+class TraceBuffer
+{
+  public:
+    /**
+     * @brief Format and add a trace, overwriting the oldest one when full
+     *
+     * @param[in] fmt - format for variable list arguments
+     * @param[in] ap - variable list arguments
+     *
+     * @return false if the message was truncated
+     */
+    bool add(const char* fmt, va_list ap);
+
+    /**
+     * @brief Remove all the traces
+     */
+    void clear();
+
+    /**
+     * @brief Append the traces to a PEL as a binary Traces section
+     *
+     * The newest traces which fit in the section are added, oldest
+     * first, seq counts the traces since the last clear. Only summary
+     * keys are added to the additional data: LOG_COUNT, LOG_LAST with
+     * the last message and LOG_DROPPED with the number of overwritten
+     * or left out traces, if any.
+     *
+     * @param[in,out] ffdcData - PEL additional data
+     * @param[in,out] sections - PEL binary FFDC sections
+     */
+    void appendTo(FFDCData& ffdcData, FFDCSections& sections) const;
+
+    /**
+     * @brief Get the most recently added message
+     *
+     * @return message, empty if there is none
+     */
+    const char* last() const;
+
+  private:
+    struct Record
+    {
+        time_t timestamp;
+        char message[TRACE_MSG_SIZE];
+    };
+
+    std::array<Record, TRACE_RECORD_COUNT> records;
+
+    /** Number of traces added since the last clear */
+    uint32_t total = 0;
+};
+
+} // namespace pel
+} // namespace openpower
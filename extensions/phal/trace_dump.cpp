@@ -0,0 +1,60 @@
+#include "config.h"
+
+#include "extensions/phal/flight_recorder.hpp"
+
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Debug tool to print PHAL trace flight recorder files
+ *
+ * Usage: phal-trace-dump [file]
+ * Default is all the recorder files in the trace directory.
+ */
+int main(int argc, char** argv)
+{
+    using namespace openpower::pel;
+
+    std::vector<fs::path> files;
+    if (argc > 1)
+    {
+        files.emplace_back(argv[1]);
+    }
+    else
+    {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(PHAL_TRACE_DIR, ec))
+        {
+            files.emplace_back(entry.path());
+        }
+    }
+
+    int rc = EXIT_SUCCESS;
+    for (const auto& file : files)
+    {
+        try
+        {
+            auto data = readRecorderFile(file);
+
+            std::cout << std::format("# {} : pid({}) {} traces({})\n",
+                                     file.string(), data.header.pid,
+                                     data.header.dirty ? "dirty" : "clean",
+                                     data.header.total);
+
+            for (const auto& [seq, timestamp, message] : data.traces)
+            {
+                std::cout << std::format("{} {}\n", getTraceKey(seq, timestamp),
+                                         message);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << std::format("Failed to read ({}): {}\n",
+                                     file.string(), e.what());
+            rc = EXIT_FAILURE;
+        }
+    }
+    return rc;
+}
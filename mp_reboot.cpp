@@ -0,0 +1,120 @@
+#include "mp_reboot.hpp"
+
+#include "parallel_ops.hpp"
+
+extern "C"
+{
+#include <libpdbg.h>
+}
+
+#include <phosphor-logging/log.hpp>
+
+#include <algorithm>
+#include <format>
+
+namespace openpower
+{
+namespace misc
+{
+
+using namespace phosphor::logging;
+
+namespace
+{
+
+/** @brief Chip-op outcome returned by a worker thread */
+struct EnterOutcome
+{
+    MpRebootStatus status = MpRebootStatus::Failed;
+    std::chrono::milliseconds duration{};
+    std::exception_ptr error;
+};
+
+const char* toString(MpRebootStatus status)
+{
+    switch (status)
+    {
+        case MpRebootStatus::Completed:
+            return "completed";
+        case MpRebootStatus::Skipped:
+            return "skipped";
+        case MpRebootStatus::Failed:
+            return "failed";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+std::vector<MpRebootResult>
+    runMpReboot(const std::vector<struct pdbg_target*>& targets,
+                MpRebootEnter enter, MpRebootReport report)
+{
+    auto task = [enter](struct pdbg_target* target) {
+        EnterOutcome outcome;
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            outcome.status = enter(target);
+        }
+        catch (...)
+        {
+            outcome.status = MpRebootStatus::Failed;
+            outcome.error = std::current_exception();
+        }
+        outcome.duration =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        return outcome;
+    };
+
+    auto outcomes = util::runParallel(targets, task, MP_REBOOT_EXPECTED_TIME);
+
+    std::vector<MpRebootResult> results(targets.size());
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+        auto& result = results[i];
+        result.index = pdbg_target_index(targets[i]);
+
+        // The task doesn't throw, the chip-op failures are in error
+        auto& outcome = *outcomes[i].value;
+        result.status = outcome.status;
+        result.duration = outcome.duration;
+        if (outcome.error)
+        {
+            report(targets[i], outcome.error, result);
+        }
+        if (outcomes[i].timedOut)
+        {
+            log<level::WARNING>(
+                std::format("Enter MPIPL on proc({}) took longer than the {} "
+                            "seconds expected",
+                            result.index, MP_REBOOT_EXPECTED_TIME.count())
+                    .c_str());
+        }
+
+        auto msg = std::format(
+            "Enter MPIPL {} on proc({}) in {} ms, errType({}) dump({})",
+            toString(result.status), result.index, result.duration.count(),
+            result.errType, result.dumpRequested);
+        if (result.status == MpRebootStatus::Failed)
+        {
+            log<level::ERR>(msg.c_str());
+        }
+        else
+        {
+            log<level::INFO>(msg.c_str());
+        }
+    }
+    return results;
+}
+
+bool mpRebootFailed(const std::vector<MpRebootResult>& results)
+{
+    return std::any_of(results.begin(), results.end(), [](const auto& r) {
+        return r.status == MpRebootStatus::Failed;
+    });
+}
+
+} // namespace misc
+} // namespace openpower
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <vector>
+
+extern "C"
+{
+struct pdbg_target;
+}
+
+namespace openpower
+{
+namespace misc
+{
+
+/**
+ * Expected duration of the enter MPIPL chip-ops of all the processors,
+ * the slower ones are only traced.
+ */
+constexpr auto MP_REBOOT_EXPECTED_TIME = std::chrono::seconds(120);
+
+/** @brief Enter MPIPL outcome of a processor */
+enum class MpRebootStatus
+{
+    Completed,
+    Skipped,
+    Failed
+};
+
+/**
+ * @brief Enter MPIPL result of a processor
+ */
+struct MpRebootResult
+{
+    /** Processor index */
+    uint32_t index = 0;
+
+    MpRebootStatus status = MpRebootStatus::Failed;
+
+    /** Platform error type of a failure, 0 if there was none */
+    int errType = 0;
+
+    /** Chip-op duration */
+    std::chrono::milliseconds duration{};
+
+    /** Set if an SBE dump was requested for the failure */
+    bool dumpRequested = false;
+};
+
+/**
+ * Issue the enter MPIPL chip-op to a processor. Runs on a worker thread
+ * and throws on failure.
+ *
+ * @return Completed, or Skipped if the SBE doesn't accept the chip-op
+ */
+using MpRebootEnter = std::function<MpRebootStatus(struct pdbg_target*)>;
+
+/**
+ * Report the exception thrown by MpRebootEnter for a processor, and fill
+ * errType and dumpRequested of its result. Runs on the calling thread.
+ */
+using MpRebootReport = std::function<void(
+    struct pdbg_target*, std::exception_ptr, MpRebootResult&)>;
+
+/**
+ * @brief Initiate memory preserving reboot on the given processors
+ *
+ * The chip-ops are issued to all the processors concurrently. The call
+ * waits for all the chip-ops to end, so the caller never exits while one
+ * is in progress, and a chip-op slower than MP_REBOOT_EXPECTED_TIME keeps
+ * its outcome. The failures are reported on the calling thread in the
+ * order of the targets, so the PELs and dump requests are created from
+ * one place.
+ *
+ * libpdbg is not thread safe, the caller probes the targets and their
+ * shared parents one at a time before the call.
+ *
+ * @param[in] targets - processor targets to issue the chip-op to
+ * @param[in] enter - platform chip-op function
+ * @param[in] report - platform failure reporting function
+ *
+ * @return results in the order of the targets
+ */
+std::vector<MpRebootResult>
+    runMpReboot(const std::vector<struct pdbg_target*>& targets,
+                MpRebootEnter enter, MpRebootReport report);
+
+/**
+ * @brief Check if memory preserving reboot failed on any processor
+ *
+ * @param[in] results - results returned by runMpReboot()
+ *
+ * @return true if a chip-op failed
+ */
+bool mpRebootFailed(const std::vector<MpRebootResult>& results);
+
+} // namespace misc
+} // namespace openpower
@@ -16,6 +16,8 @@
 
 #include "nmi_interface.hpp"
 
+#include "parallel_ops.hpp"
+
 extern "C"
 {
 #include <libpdbg.h>
@@ -26,6 +28,12 @@ extern "C"
 #include <phosphor-logging/elog.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <map>
+#include <vector>
+
 namespace openpower
 {
 namespace proc
@@ -35,12 +43,55 @@ NMI::NMI(sdbusplus::bus_t& bus, const char* path) :
     Interface(bus, path), bus(bus), objectPath(path)
 {}
 
+namespace
+{
+
+/**
+ * Expected duration of the thread stops of all the processors, the slower
+ * ones are only traced. A hung thread stop is ended by the FSI driver.
+ */
+constexpr auto THREAD_STOP_EXPECTED_TIME = std::chrono::seconds(10);
+
+/**
+ * @brief Stop the given threads of a processor
+ *
+ * @param[in] threads - enabled thread targets of one processor
+ *
+ * @return number of threads which failed to stop
+ */
+size_t stopThreads(const std::vector<struct pdbg_target*>& threads)
+{
+    size_t failed = 0;
+    for (auto thread : threads)
+    {
+        if (thread_stop(thread) < 0)
+        {
+            failed++;
+        }
+    }
+    return failed;
+}
+
+} // namespace
+
 void NMI::nmi()
 {
     using namespace phosphor::logging;
     using InternalFailure =
         sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
 
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    };
+
+    // Probe serially and group the threads per processor, the processors
+    // are then stopped in parallel so the time to quiesce the host
+    // doesn't grow with the number of processors.
+    std::map<struct pdbg_target*, std::vector<struct pdbg_target*>> procs;
+    std::vector<struct pdbg_target*> threads;
     struct pdbg_target* target;
 
     pdbg_for_each_class_target("thread", target)
@@ -48,19 +99,71 @@ void NMI::nmi()
         if (pdbg_target_probe(target) != PDBG_TARGET_ENABLED)
             continue;
 
-        if (thread_stop(target) < 0 || !thread_status(target).quiesced)
+        procs[pdbg_target_parent("pib", target)].push_back(target);
+        threads.push_back(target);
+    }
+
+    std::vector<std::vector<struct pdbg_target*>> groups;
+    groups.reserve(procs.size());
+    for (auto& [proc, procThreads] : procs)
+    {
+        groups.push_back(std::move(procThreads));
+    }
+
+    // Returns once every worker ended, even past the expected time, so
+    // no thread_stop is still running when the threads are verified and
+    // sreset, or when the next NMI request is handled.
+    auto results =
+        util::runParallel(groups, stopThreads, THREAD_STOP_EXPECTED_TIME);
+    auto stopTime = elapsed();
+
+    bool failed = false;
+    for (const auto& result : results)
+    {
+        if (result.timedOut)
+        {
+            log<level::WARNING>(
+                std::format("Thread stop took longer than the {} seconds "
+                            "expected",
+                            THREAD_STOP_EXPECTED_TIME.count())
+                    .c_str());
+        }
+        if (result.error || (*result.value != 0))
         {
-            log<level::ERR>("Failed to stop all threads");
-            report<InternalFailure>();
-            return;
+            failed = true;
         }
     }
 
+    // Verify the quiesce of all the threads in one pass, after the
+    // stops of all the processors completed.
+    if (!failed)
+    {
+        failed = std::any_of(threads.begin(), threads.end(), [](auto thread) {
+            return !thread_status(thread).quiesced;
+        });
+    }
+
+    if (failed)
+    {
+        log<level::ERR>(
+            std::format("Failed to stop all threads in {} ms", elapsed())
+                .c_str());
+        report<InternalFailure>();
+        return;
+    }
+
     if (thread_sreset_all() < 0)
     {
         log<level::ERR>("Failed to sreset all threads");
         report<InternalFailure>();
+        return;
     }
+
+    log<level::INFO>(
+        std::format("NMI completed in {} ms, stopped ({}) threads on ({}) "
+                    "processors in {} ms",
+                    elapsed(), threads.size(), groups.size(), stopTime)
+            .c_str());
 }
 } // namespace proc
 } // namespace openpower
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace openpower
+{
+namespace util
+{
+
+/**
+ * @brief Outcome of one task of runParallel()
+ */
+template <typename Result>
+struct TaskResult
+{
+    /** Task return value, empty if the task threw */
+    std::optional<Result> value;
+
+    /** Exception thrown by the task, if any */
+    std::exception_ptr error;
+
+    /** Set if the task took longer than the expected time */
+    bool timedOut = false;
+};
+
+/**
+ * @brief Run a task for each item concurrently
+ *
+ * Every item gets its own worker thread, so the total time is close to
+ * the slowest task instead of the sum of all of them. The tasks which
+ * did not complete within the expected time are reported as timed out.
+ *
+ * The expected time is not a deadline, a blocked hardware access can't
+ * be cancelled, so the call waits for all the workers before returning.
+ * The caller never requests dumps, creates PELs or exits while a worker
+ * is inside libpdbg or libphal, and the value of a late task is kept.
+ * libpdbg is not thread safe, the targets shared by the items must be
+ * probed by the caller, one at a time, before the call.
+ *
+ * @param[in] items - task arguments, one task per item
+ * @param[in] task - callable taking an item and returning a value
+ * @param[in] expected - expected time of the tasks, counted from the call
+ *
+ * @return task outcomes, in the order of the items
+ */
+template <typename Item, typename Task>
+auto runParallel(const std::vector<Item>& items, Task&& task,
+                 std::chrono::steady_clock::duration expected)
+    -> std::vector<TaskResult<std::invoke_result_t<Task&, const Item&>>>
+{
+    using Result = std::invoke_result_t<Task&, const Item&>;
+
+    auto expectedEnd = std::chrono::steady_clock::now() + expected;
+
+    // Not resized once the workers started, they reference the elements
+    std::vector<std::packaged_task<Result()>> work;
+    work.reserve(items.size());
+    std::vector<std::future<Result>> futures;
+    futures.reserve(items.size());
+    for (const auto& item : items)
+    {
+        work.emplace_back([&task, &item]() { return task(item); });
+        futures.emplace_back(work.back().get_future());
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(items.size());
+    for (auto& itemWork : work)
+    {
+        try
+        {
+            workers.emplace_back([&itemWork]() { itemWork(); });
+        }
+        catch (const std::system_error&)
+        {
+            // Out of threads, run it on the calling thread instead
+            itemWork();
+        }
+    }
+
+    std::vector<TaskResult<Result>> results(items.size());
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        if (futures[i].wait_until(expectedEnd) != std::future_status::ready)
+        {
+            results[i].timedOut = true;
+        }
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        try
+        {
+            results[i].value.emplace(futures[i].get());
+        }
+        catch (...)
+        {
+            results[i].error = std::current_exception();
+        }
+    }
+    return results;
+}
+
+} // namespace util
+} // namespace openpower
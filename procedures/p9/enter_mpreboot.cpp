@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "mp_reboot.hpp"
 #include "registration.hpp"
 
 extern "C"
@@ -22,11 +23,9 @@ extern "C"
 #include <libpdbg_sbe.h>
 }
 
-#include <sys/wait.h>
-#include <unistd.h>
-
 #include <phosphor-logging/log.hpp>
 
+#include <exception>
 #include <format>
 #include <system_error>
 #include <vector>
@@ -38,23 +37,53 @@ namespace misc
 
 /**
  * @brief Calls sbe_enter_mpipl on the SBE in the provided target.
- * @return void
+ *        Runs on a worker thread.
+ * @return Completed
  */
-void sbeEnterMpReboot(struct pdbg_target* tgt)
+MpRebootStatus sbeEnterMpReboot(struct pdbg_target* tgt)
 {
-    using namespace phosphor::logging;
     int error = 0;
     if ((error = sbe_mpipl_enter(tgt)) < 0)
     {
-        log<level::ERR>("Failed to initiate memory preserving reboot");
         // TODO Create a PEL in the future for this failure case.
         throw std::system_error(error, std::generic_category(),
                                 "Failed to initiate memory preserving reboot");
     }
+    return MpRebootStatus::Completed;
+}
 
-    log<level::INFO>(
-        std::format("Enter MPIPL completed on proc({})", pdbg_target_index(tgt))
-            .c_str());
+/**
+ * @brief Log an enter MPIPL failure.
+ * @param[in] tgt - pib target
+ * @param[in] error - exception thrown by sbeEnterMpReboot()
+ * @param[in,out] result - enter MPIPL result of the processor
+ * @return void
+ */
+void reportMpRebootFailure(struct pdbg_target* tgt, std::exception_ptr error,
+                           MpRebootResult& result)
+{
+    using namespace phosphor::logging;
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch (const std::system_error& e)
+    {
+        result.errType = e.code().value();
+        log<level::ERR>(
+            std::format("Failed to initiate memory preserving reboot "
+                        "on proc({}): {}",
+                        pdbg_target_index(tgt), e.what())
+                .c_str());
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            std::format("Failed to initiate memory preserving reboot "
+                        "on proc({}): {}",
+                        pdbg_target_index(tgt), e.what())
+                .c_str());
+    }
 }
 
 /**
@@ -65,49 +94,24 @@ void enterMpReboot()
 {
     using namespace phosphor::logging;
     struct pdbg_target* target;
-    std::vector<pid_t> pidList;
-    bool failed = false;
+    std::vector<struct pdbg_target*> pibs;
     pdbg_targets_init(NULL);
 
     log<level::INFO>("Starting memory preserving reboot");
+    // Probed one at a time here, the chip-ops then run concurrently
     pdbg_for_each_class_target("pib", target)
     {
         if (pdbg_target_probe(target) != PDBG_TARGET_ENABLED)
         {
             continue;
         }
-
-        pid_t pid = fork();
-
-        if (pid < 0)
-        {
-            log<level::ERR>("Fork failed while starting mp reboot");
-            failed = true;
-        }
-        else if (pid == 0)
-        {
-            sbeEnterMpReboot(target);
-            std::exit(EXIT_SUCCESS);
-        }
-        else
-        {
-            pidList.push_back(std::move(pid));
-        }
-    }
-
-    for (auto& p : pidList)
-    {
-        int status = 0;
-        waitpid(p, &status, 0);
-        if (WEXITSTATUS(status))
-        {
-            log<level::ERR>("Memory preserving reboot failed");
-            failed = true;
-        }
+        pibs.push_back(target);
     }
 
-    if (failed)
+    auto results = runMpReboot(pibs, sbeEnterMpReboot, reportMpRebootFailure);
+    if (mpRebootFailed(results))
     {
+        log<level::ERR>("Memory preserving reboot failed");
         std::exit(EXIT_FAILURE);
     }
 }
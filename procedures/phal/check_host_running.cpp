@@ -8,6 +8,7 @@ extern "C"
 #include "extensions/phal/pdbg_utils.hpp"
 #include "p10_cfam.hpp"
 #include "registration.hpp"
+#include "util.hpp"
 
 #include <phosphor-logging/log.hpp>
 #include <sdbusplus/bus.hpp>
@@ -27,7 +28,7 @@ using namespace phosphor::logging;
 /** Best effort function to create a BMC dump */
 void createBmcDump()
 {
-    auto bus = sdbusplus::bus::new_default();
+    auto& bus = util::getBus();
 
     auto method = bus.new_method_call(
         "xyz.openbmc_project.Dump.Manager", "/xyz/openbmc_project/dump/bmc",
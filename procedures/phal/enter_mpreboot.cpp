@@ -24,17 +24,17 @@ extern "C"
 
 #include "extensions/phal/create_pel.hpp"
 #include "extensions/phal/dump_utils.hpp"
+#include "extensions/phal/pdbg_utils.hpp"
+#include "mp_reboot.hpp"
 
 #include <attributes_info.H>
 #include <libphal.H>
 #include <phal_exception.H>
-#include <sys/wait.h>
-#include <unistd.h>
 
 #include <phosphor-logging/log.hpp>
 
+#include <exception>
 #include <format>
-#include <system_error>
 #include <vector>
 
 namespace openpower
@@ -44,11 +44,12 @@ namespace misc
 
 /**
  * @brief Calls sbe_enter_mpipl on the SBE in the provided target.
- * @return void
+ *        Runs on a worker thread, the failures are reported by
+ *        reportMpRebootFailure().
+ * @return Completed, or Skipped if the SBE doesn't accept chip-ops
  */
-void sbeEnterMpReboot(struct pdbg_target* tgt)
+MpRebootStatus sbeEnterMpReboot(struct pdbg_target* tgt)
 {
-    using namespace openpower::pel;
     using namespace openpower::phal;
     using namespace openpower::phal::sbe;
     using namespace openpower::phal::exception;
@@ -68,12 +69,39 @@ void sbeEnterMpReboot(struct pdbg_target* tgt)
                 std::format("EnterMPIPL: Skipping ({}) on proc({})",
                             sbeError.what(), pdbg_target_index(tgt))
                     .c_str());
-            return;
+            return MpRebootStatus::Skipped;
         }
+        throw;
+    }
+    return MpRebootStatus::Completed;
+}
 
+/**
+ * @brief Create the PEL and request the SBE dump for an enter MPIPL
+ *        failure.
+ * @param[in] tgt - processor target
+ * @param[in] error - exception thrown by sbeEnterMpReboot()
+ * @param[in,out] result - enter MPIPL result of the processor
+ * @return void
+ */
+void reportMpRebootFailure(struct pdbg_target* tgt, std::exception_ptr error,
+                           MpRebootResult& result)
+{
+    using namespace openpower::pel;
+    using namespace openpower::phal;
+    using namespace openpower::phal::exception;
+    using namespace phosphor::logging;
+
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch (const sbeError_t& sbeError)
+    {
         log<level::ERR>(std::format("EnterMPIPL failed({}) on proc({})",
                                     sbeError.what(), pdbg_target_index(tgt))
                             .c_str());
+        result.errType = sbeError.errType();
 
         std::string event;
         bool dumpIsRequired = false;
@@ -103,15 +131,24 @@ void sbeEnterMpReboot(struct pdbg_target* tgt)
                                        std::to_string((index << 16) | cmd));
         auto logId = createSbeErrorPEL(event, sbeError, pelAdditionalData, tgt);
 
-        if (dumpIsRequired)
+        if (dumpIsRequired && (logId == 0))
+        {
+            // Duplicate dropped by the rate limit, the first occurrence
+            // already requested the dump.
+            log<level::INFO>(
+                std::format("Skipping SBE dump of proc({}), PEL was dropped",
+                            index)
+                    .c_str());
+        }
+        else if (dumpIsRequired)
         {
             // Request SBE Dump
             using namespace openpower::phal::dump;
             DumpParameters dumpParameters = {logId, index, SBE_DUMP_TIMEOUT,
                                              DumpType::SBE};
             requestDump(dumpParameters);
+            result.dumpRequested = true;
         }
-        throw;
     }
     // Capture genaral libphal error
     catch (const phalError_t& phalError)
@@ -120,14 +157,16 @@ void sbeEnterMpReboot(struct pdbg_target* tgt)
         log<level::ERR>(std::format("captureFFDC: Exception({}) on proc({})",
                                     phalError.what(), pdbg_target_index(tgt))
                             .c_str());
+        result.errType = phalError.errType();
         openpower::pel::createPEL(
             "org.open_power.Processor.Error.SbeChipOpFailure");
-        throw;
     }
-
-    log<level::INFO>(
-        std::format("Enter MPIPL completed on proc({})", pdbg_target_index(tgt))
-            .c_str());
+    catch (const std::exception& ex)
+    {
+        log<level::ERR>(std::format("EnterMPIPL: Exception({}) on proc({})",
+                                    ex.what(), pdbg_target_index(tgt))
+                            .c_str());
+    }
 }
 
 /**
@@ -138,8 +177,7 @@ void enterMpReboot()
 {
     using namespace phosphor::logging;
     struct pdbg_target* target;
-    std::vector<pid_t> pidList;
-    bool failed = false;
+    std::vector<struct pdbg_target*> procs;
     pdbg_targets_init(NULL);
     ATTR_HWAS_STATE_Type hwasState;
 
@@ -154,46 +192,25 @@ void enterMpReboot()
         {
             continue;
         }
-
-        pid_t pid = fork();
-
-        if (pid < 0)
-        {
-            log<level::ERR>("Fork failed while starting mp reboot");
-            failed = true;
-        }
-        else if (pid == 0)
-        {
-            sbeEnterMpReboot(target);
-            std::exit(EXIT_SUCCESS);
-        }
-        else
-        {
-            pidList.push_back(std::move(pid));
-        }
+        procs.push_back(target);
     }
 
     // if no functional proc found exit with failure
-    if (pidList.size() == 0)
+    if (procs.size() == 0)
     {
         log<level::ERR>("EnterMPReboot is not executed on any processors");
         openpower::pel::createPEL("org.open_power.PHAL.Error.MPReboot");
         std::exit(EXIT_FAILURE);
     }
 
-    for (auto& p : pidList)
-    {
-        int status = 0;
-        waitpid(p, &status, 0);
-        if (WEXITSTATUS(status))
-        {
-            log<level::ERR>("Memory preserving reboot failed");
-            failed = true;
-        }
-    }
+    // The processors share FSI ancestors, probe them one at a time before
+    // the chip-ops access them concurrently.
+    openpower::phal::probeProcTargets(procs);
 
-    if (failed)
+    auto results = runMpReboot(procs, sbeEnterMpReboot, reportMpRebootFailure);
+    if (mpRebootFailed(results))
     {
+        log<level::ERR>("Memory preserving reboot failed");
         std::exit(EXIT_FAILURE);
     }
 }
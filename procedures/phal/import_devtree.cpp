@@ -2,8 +2,10 @@
 
 #include "extensions/phal/create_pel.hpp"
 #include "extensions/phal/pdbg_utils.hpp"
+#include "extensions/phal/preserved_attrs.hpp"
 #include "registration.hpp"
 
+#include <libphal.H>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -12,8 +14,10 @@
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <cstdlib>
 #include <filesystem>
 #include <format>
+#include <string>
 
 namespace openpower
 {
@@ -22,21 +26,18 @@ namespace phal
 
 using namespace phosphor::logging;
 
-void importDevtree()
+namespace fs = std::filesystem;
+
+/**
+ * @brief Import text format attribute data using the attributes tool
+ *
+ * Export data file written by an older firmware level, before the binary
+ * preserved attribute container was introduced.
+ *
+ * @return true on success
+ */
+static bool importLegacyDevtree()
 {
-    namespace fs = std::filesystem;
-
-    // check import data file is present
-    auto path = fs::path(DEVTREE_EXP_FILE);
-    if (!fs::exists(path))
-    {
-        // No import data file skip devtree import
-        return;
-    }
-
-    // Update PDBG_DTB value
-    openpower::phal::setDevtreeEnv();
-
     // Update PDATA_INFODB value
     openpower::phal::setPdataInfoDBEnv();
 
@@ -56,6 +57,7 @@ void importDevtree()
                                     "execution, errno({})",
                                     error)
                             .c_str());
+        _exit(EXIT_FAILURE);
     }
     else if (pid > 0)
     {
@@ -63,8 +65,7 @@ void importDevtree()
         if (WEXITSTATUS(status))
         {
             log<level::ERR>("Failed to import attribute data");
-            openpower::pel::createPEL("org.open_power.PHAL.Error.devtreeSync");
-            return;
+            return false;
         }
     }
     else
@@ -72,6 +73,86 @@ void importDevtree()
         log<level::ERR>("fork() failed.");
         throw std::runtime_error("importDevtree: fork() failed.");
     }
+    return true;
+}
+
+/**
+ * @brief Apply binary preserved attribute container to the devtree
+ *
+ * The complete file is validated before any attribute is updated. The
+ * records which could not be applied are reported in an informational
+ * PEL, since the file is deleted afterwards.
+ *
+ * @return true on success
+ */
+static bool importDevtreeContainer()
+{
+    attrs::Container container;
+    try
+    {
+        container = attrs::readFile(DEVTREE_EXP_FILE);
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>(
+            std::format("Invalid attribute data file({}) ({})",
+                        DEVTREE_EXP_FILE, e.what())
+                .c_str());
+        return false;
+    }
+
+    openpower::phal::pdbg::init();
+
+    auto skipped = attrs::apply(container);
+    auto applied = container.records.size() - skipped;
+    log<level::INFO>(std::format("Applied ({}) preserved attributes, "
+                                 "skipped ({})",
+                                 applied, skipped)
+                         .c_str());
+    if (skipped > 0)
+    {
+        openpower::pel::FFDCData ffdcData = {
+            {"REASON_FOR_PEL", "Preserved attributes skipped on import"},
+            {"APPLIED_COUNT", std::to_string(applied)},
+            {"SKIPPED_COUNT", std::to_string(skipped)}};
+        try
+        {
+            openpower::pel::createPEL(
+                "org.open_power.PHAL.Error.devtreeSync", ffdcData,
+                openpower::pel::Severity::Informational);
+        }
+        catch (const std::exception& e)
+        {
+            // The attributes are applied, only the report is lost
+            log<level::ERR>(
+                std::format("Failed to report skipped attributes ({})",
+                            e.what())
+                    .c_str());
+        }
+    }
+    return true;
+}
+
+void importDevtree()
+{
+    // check import data file is present
+    auto path = fs::path(DEVTREE_EXP_FILE);
+    if (!fs::exists(path))
+    {
+        // No import data file skip devtree import
+        return;
+    }
+
+    // Update PDBG_DTB value
+    openpower::phal::setDevtreeEnv();
+
+    bool imported = attrs::isContainerFile(path) ? importDevtreeContainer()
+                                                 : importLegacyDevtree();
+    if (!imported)
+    {
+        openpower::pel::createPEL("org.open_power.PHAL.Error.devtreeSync");
+        return;
+    }
 
     try
     {
@@ -1,6 +1,8 @@
 #include "config.h"
 
 #include "extensions/phal/create_pel.hpp"
+#include "extensions/phal/pdbg_utils.hpp"
+#include "extensions/phal/preserved_attrs.hpp"
 #include "registration.hpp"
 #include "temporary_file.hpp"
 
@@ -12,6 +14,10 @@
 #include <cstdio>
 #include <filesystem>
 #include <format>
+#include <fstream>
+#include <optional>
+#include <set>
+#include <sstream>
 
 extern "C"
 {
@@ -62,36 +68,70 @@ void applyAttrOverride(fs::path& devtreeFile)
 }
 
 /**
- * @brief Compute RO device tree file path from RW symbolic link
- * @return RO file path one failure exception will be thrown
+ * @brief Get the reinit attribute list reduced to the changed attributes
+ *
+ * Attributes which still hold the r/o genesis value in the r/w devtree
+ * are restored by the r/o copy itself, so they don't need to go through
+ * the export and import steps.
+ *
+ * @param[in] roFilePath - r/o devtree file path
+ * @param[in] listFile - file to write the reduced attribute list to
+ *
+ * @return attribute list file to use, std::nullopt if nothing changed
  */
-fs::path computeRODeviceTreePath()
+std::optional<fs::path> getChangedAttrList(const fs::path& roFilePath,
+                                           const fs::path& listFile)
 {
-    // Symbolic links are not created for RO files, compute the lid name
-    // for the RW symbolic link and use it to compute RO file.
-    // Example:
-    // RW file = /media/hostfw/running/DEVTREE -> 81e00672.lid
-    // RO file = /media/hostfw/running-ro/ + 81e00672.lid
-    fs::path rwFileName = fs::read_symlink(CEC_DEVTREE_RW_PATH);
-    if (rwFileName.empty())
+    using namespace openpower::phal::attrs;
+
+    std::set<std::string> changed;
+    try
+    {
+        auto attrNames = readAttrList(DEVTREE_REINIT_ATTRS_LIST);
+        auto changedNames =
+            changedAttrs(readDevtreeBlob(CEC_DEVTREE_RW_PATH, attrNames),
+                         readDevtreeBlob(roFilePath, attrNames));
+        changed.insert(changedNames.begin(), changedNames.end());
+
+        log<level::INFO>(std::format("reinitDevtree: ({}) of ({}) attributes "
+                                     "differ from the r/o devtree",
+                                     changed.size(), attrNames.size())
+                             .c_str());
+    }
+    catch (const std::exception& e)
     {
-        std::string err =
-            std::format("Failed to read the target file "
-                        "for the RW device tree symbolic link ({})",
-                        CEC_DEVTREE_RW_PATH);
-        log<level::ERR>(err.c_str());
-        throw std::runtime_error(err);
+        // Fall back to the complete list
+        log<level::ERR>(
+            std::format("reinitDevtree: attribute compare failed ({})",
+                        e.what())
+                .c_str());
+        return fs::path(DEVTREE_REINIT_ATTRS_LIST);
     }
-    fs::path roFilePath = CEC_DEVTREE_RO_BASE_PATH / rwFileName;
-    if (!fs::exists(roFilePath))
+
+    if (changed.empty())
     {
-        auto err = std::format("RO device tree file ({}) does not "
-                               "exit ",
-                               roFilePath.string());
-        log<level::ERR>(err.c_str());
-        throw std::runtime_error(err);
+        return std::nullopt;
     }
-    return roFilePath;
+
+    // Keep the original list entries of the changed attributes
+    std::ifstream in(DEVTREE_REINIT_ATTRS_LIST);
+    std::ofstream out(listFile, std::ios::trunc);
+    for (std::string line; std::getline(in, line);)
+    {
+        std::string name;
+        std::istringstream(line) >> name;
+        if (changed.contains(name))
+        {
+            out << line << '\n';
+        }
+    }
+    out.close();
+    if (!out)
+    {
+        throw std::runtime_error(
+            "reinitDevtree: failed to write reduced attribute list");
+    }
+    return listFile;
 }
 
 /**
@@ -103,11 +143,13 @@ fs::path computeRODeviceTreePath()
  * This function helps to meet the host ipl requirement
  * related to attribute persistency management for host ipl.
  * Steps involved
+ * 1a. Reduce the reinit attribute list to the attributes which differ
+ *     from the devtree r/o version.
  * 1. Create attribute data file from devtree r/w version based on
- *    the reinit attribute list file bmc /usr/share/pdata path.
+ *    the reduced reinit attribute list.
  * 2. Create temporary devtree file by copying devtree r/o file
  * 3. Override temporary copy of devtree with attribute data file
- *    from step 1.
+ *    from step 1. Steps 1 and 3 are skipped if no attribute changed.
  * 3a. Apply user provided attribute override if present in the
  *     predefined location.
  * 4. Copy  temporary copy devtree to r/w devtree version file.
@@ -146,9 +188,16 @@ void reinitDevtree()
             throw std::runtime_error("reinitDevtree: missing export list file");
         }
 
+        // Step 1a: Reduce the reinit list to the attributes which hold a
+        // different value than the r/o genesis devtree.
+        fs::path roFilePath = computeRODeviceTreePath();
+        openpower::util::TemporaryFile tmpListFile{};
+        auto attrList = getChangedAttrList(roFilePath, tmpListFile.getPath());
+
         // create temporary data file to store the devtree export data
         openpower::util::TemporaryFile tmpFile{};
 
+        if (attrList)
         {
             // get temporary datafile pointer.
             FILE_Ptr fpExport(fopen(tmpFile.getPath().c_str(), "w+"),
@@ -166,8 +215,7 @@ void reinitDevtree()
 
             // Step 1: export devtree data based on the reinit attribute list.
             auto ret = dtree_cronus_export(CEC_DEVTREE_RW_PATH, CEC_INFODB_PATH,
-                                           DEVTREE_REINIT_ATTRS_LIST,
-                                           fpExport.get());
+                                           attrList->c_str(), fpExport.get());
             if (ret)
             {
                 log<level::ERR>(
@@ -180,31 +228,36 @@ void reinitDevtree()
         }
 
         // Step 2: Create temporary devtree file by copying devtree r/o version
-        fs::path roFilePath = computeRODeviceTreePath();
         std::filesystem::copy(roFilePath, tmpDevtreePath, copyOptions);
 
-        // get r/o version data file pointer
-        FILE_Ptr fpImport(fopen(tmpFile.getPath().c_str(), "r"), FileCloser());
-        if (fpImport.get() == nullptr)
+        if (attrList)
         {
-            log<level::ERR>(
-                std::format("import, temporary data file failed to open: ({})",
-                            tmpFile.getPath().c_str())
-                    .c_str());
-            throw std::runtime_error(
-                "reinitDevtree: import, failed to open temporaray data file");
-        }
+            // get r/o version data file pointer
+            FILE_Ptr fpImport(fopen(tmpFile.getPath().c_str(), "r"),
+                              FileCloser());
+            if (fpImport.get() == nullptr)
+            {
+                log<level::ERR>(
+                    std::format(
+                        "import, temporary data file failed to open: ({})",
+                        tmpFile.getPath().c_str())
+                        .c_str());
+                throw std::runtime_error("reinitDevtree: import, failed to "
+                                         "open temporaray data file");
+            }
 
-        // Step 3: Update Devtree r/w version with data file attribute data.
-        auto ret = dtree_cronus_import(tmpDevtreePath.c_str(), CEC_INFODB_PATH,
-                                       fpImport.get());
-        if (ret)
-        {
-            log<level::ERR>(
-                std::format("Failed({}) to update attribute data", ret)
-                    .c_str());
-            throw std::runtime_error(
-                "reinitDevtree: dtree_cronus_import function failed");
+            // Step 3: Update Devtree r/w version with data file attribute
+            // data.
+            auto ret = dtree_cronus_import(tmpDevtreePath.c_str(),
+                                           CEC_INFODB_PATH, fpImport.get());
+            if (ret)
+            {
+                log<level::ERR>(
+                    std::format("Failed({}) to update attribute data", ret)
+                        .c_str());
+                throw std::runtime_error(
+                    "reinitDevtree: dtree_cronus_import function failed");
+            }
         }
         // Step 3.a: Apply user provided attribute override data if present.
         applyAttrOverride(tmpDevtreePath);
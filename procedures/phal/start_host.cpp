@@ -103,7 +103,7 @@ void setClkNETerminationSite()
     constexpr auto kwdVpdInf = "com.ibm.ipzvpd.VINI";
     constexpr auto hwKwd = "HW";
 
-    auto bus = sdbusplus::bus::new_default();
+    auto& bus = util::getBus();
 
     std::string service = util::getService(bus, objPath, kwdVpdInf);
 
@@ -231,21 +231,13 @@ static bool allowHwIsolation()
 
     try
     {
-        auto bus = sdbusplus::bus::new_default();
+        auto& bus = util::getBus();
 
         std::string service = util::getService(bus, hwIsolationPolicyObjPath,
                                                hwIsolationPolicyIface);
 
-        auto method =
-            bus.new_method_call(service.c_str(), hwIsolationPolicyObjPath,
-                                "org.freedesktop.DBus.Properties", "Get");
-        method.append(hwIsolationPolicyIface, "Enabled");
-
-        auto reply = bus.call(method);
-
-        std::variant<bool> resp;
-
-        reply.read(resp);
+        auto resp = util::getProperty(service, hwIsolationPolicyObjPath,
+                                      hwIsolationPolicyIface, "Enabled");
 
         if (const bool* enabledPropVal = std::get_if<bool>(&resp))
         {
@@ -264,7 +256,7 @@ static bool allowHwIsolation()
                                                {{"REASON_FOR_PEL", trace}});
         }
     }
-    catch (const sdbusplus::exception_t& e)
+    catch (const std::exception& e)
     {
         const auto trace{std::format(
             "Exception [{}] to get the HardwareIsolation policy "
@@ -1,5 +1,7 @@
 #include "extensions/phal/create_pel.hpp"
 #include "extensions/phal/dump_utils.hpp"
+#include "extensions/phal/pdbg_utils.hpp"
+#include "parallel_ops.hpp"
 #include "registration.hpp"
 
 #include <attributes_info.H>
@@ -7,7 +9,11 @@
 #include <libphal.H>
 #include <phal_exception.H>
 
+#include <chrono>
+#include <exception>
 #include <format>
+#include <optional>
+#include <vector>
 extern "C"
 {
 #include <libpdbg.h>
@@ -22,6 +28,52 @@ using namespace openpower::pel;
 using namespace openpower::phal::exception;
 using namespace phosphor::logging;
 
+/*
+ * Expected duration of the thread stop chip-ops of all the processors,
+ * the slower ones are only traced. A hung chip-op is ended by the SBE
+ * FIFO driver timeout, libphal has no per chip-op timeout.
+ */
+constexpr auto THREAD_STOP_EXPECTED_TIME = std::chrono::seconds(30);
+
+/**
+ * @brief Thread stop chip-op outcome of one processor
+ */
+struct ThreadStopResult
+{
+    /** SBE error reported by the chip-op, if any */
+    std::optional<sbeError_t> sbeError;
+
+    /** Chip-op duration */
+    std::chrono::milliseconds duration{};
+};
+
+/**
+ * @brief Issue the thread stop chip-op to a processor
+ *
+ * Runs on a worker thread, SBE errors are returned to the caller which
+ * creates the PELs.
+ *
+ * @param[in] procTarget - pdbg processor target
+ *
+ * @return chip-op outcome
+ */
+static ThreadStopResult stopProcThreads(struct pdbg_target* procTarget)
+{
+    ThreadStopResult result;
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        openpower::phal::sbe::threadStopProc(procTarget);
+    }
+    catch (const sbeError_t& sbeError)
+    {
+        result.sbeError = sbeError;
+    }
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    return result;
+}
+
 /**
  * @brief Stop instruction executions on all functional threads in the
  *        host processors.
@@ -29,6 +81,8 @@ using namespace phosphor::logging;
  *        Attempt best case approch. Like issue processor level stopall
  *        chip-op with ignore hardware error mode. Since this function
  *        is used in power-off/error path, ignore the internal error now.
+ *        The chip-ops are issued to all the processors concurrently, so
+ *        a slow SBE doesn't delay the chip-ops of the others.
  */
 void threadStopAll(void)
 {
@@ -49,6 +103,7 @@ void threadStopAll(void)
             return;
         }
 
+        std::vector<struct pdbg_target*> procs;
         struct pdbg_target* procTarget;
         ATTR_HWAS_STATE_Type hwasState;
         pdbg_for_each_class_target("proc", procTarget)
@@ -65,58 +120,93 @@ void threadStopAll(void)
             {
                 continue;
             }
+            procs.push_back(procTarget);
+        }
+
+        // The processors share FSI ancestors, probe them one at a time
+        // before the chip-ops access them concurrently.
+        probeProcTargets(procs);
+
+        // Returns once all the chip-ops ended, so the procedure never
+        // exits while an SBE FIFO access is in progress. The power off
+        // waits as long as the slowest SBE.
+        auto results = util::runParallel(procs, stopProcThreads,
+                                         THREAD_STOP_EXPECTED_TIME);
+
+        // The PELs of all the processors are created before a non SBE
+        // failure is handled.
+        std::exception_ptr failure;
+        for (size_t i = 0; i < procs.size(); i++)
+        {
+            auto& result = results[i];
+            uint32_t index = pdbg_target_index(procs[i]);
 
-            try
+            if (result.timedOut)
             {
-                openpower::phal::sbe::threadStopProc(procTarget);
+                log<level::ERR>(
+                    std::format("threadStopAll took longer than the {} "
+                                "seconds expected on proc({})",
+                                THREAD_STOP_EXPECTED_TIME.count(), index)
+                        .c_str());
             }
-            catch (const sbeError_t& sbeError)
+            if (result.error)
             {
-                auto errType = sbeError.errType();
-
-                // Create PEL only for  valid SBE reported failures
-                if (errType == SBE_CMD_FAILED)
-                {
-                    log<level::ERR>(
-                        std::format(
-                            "threadStopAll failed({}) on proc({})",
-                            static_cast<
-                                std::underlying_type<ipl_error_type>::type>(
-                                errType),
-                            pdbg_target_index(procTarget))
-                            .c_str());
-
-                    uint32_t index = pdbg_target_index(procTarget);
-                    // To store additional data about ffdc.
-                    FFDCData pelAdditionalData;
-
-                    // SRC6 : [0:15] chip position
-                    //        [16:23] command class,  [24:31] Type
-                    pelAdditionalData.emplace_back(
-                        "SRC6", std::to_string((index << 16) | cmd));
-
-                    // Create informational error log.
-                    createSbeErrorPEL(
-                        "org.open_power.Processor.Error.SbeChipOpFailure",
-                        sbeError, pelAdditionalData, procTarget,
-                        Severity::Informational);
-                }
-                else
-                {
-                    // SBE is not ready to accept chip-ops,
-                    // Skip the request, no additional error handling required.
-                    log<level::INFO>(
-                        std::format("threadStopAll: Skipping ({}) on proc({})",
-                                    sbeError.what(),
-                                    pdbg_target_index(procTarget))
-                            .c_str());
-                }
+                failure = failure ? failure : result.error;
                 continue;
             }
-            log<level::INFO>(
-                std::format("Processor thread stopall completed on proc({})",
-                            pdbg_target_index(procTarget))
-                    .c_str());
+
+            if (!result.value->sbeError)
+            {
+                log<level::INFO>(
+                    std::format("Processor thread stopall completed on "
+                                "proc({}) in {} ms",
+                                index, result.value->duration.count())
+                        .c_str());
+                continue;
+            }
+
+            const auto& sbeError = *result.value->sbeError;
+            auto errType = sbeError.errType();
+
+            // Create PEL only for  valid SBE reported failures
+            if (errType == SBE_CMD_FAILED)
+            {
+                log<level::ERR>(
+                    std::format(
+                        "threadStopAll failed({}) on proc({}) in {} ms",
+                        static_cast<std::underlying_type<ipl_error_type>::type>(
+                            errType),
+                        index, result.value->duration.count())
+                        .c_str());
+
+                // To store additional data about ffdc.
+                FFDCData pelAdditionalData;
+
+                // SRC6 : [0:15] chip position
+                //        [16:23] command class,  [24:31] Type
+                pelAdditionalData.emplace_back(
+                    "SRC6", std::to_string((index << 16) | cmd));
+
+                // Create informational error log.
+                createSbeErrorPEL(
+                    "org.open_power.Processor.Error.SbeChipOpFailure",
+                    sbeError, pelAdditionalData, procs[i],
+                    Severity::Informational);
+            }
+            else
+            {
+                // SBE is not ready to accept chip-ops,
+                // Skip the request, no additional error handling required.
+                log<level::INFO>(
+                    std::format("threadStopAll: Skipping ({}) on proc({})",
+                                sbeError.what(), index)
+                        .c_str());
+            }
+        }
+
+        if (failure)
+        {
+            std::rethrow_exception(failure);
         }
     }
     // Capture general exception
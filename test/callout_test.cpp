@@ -0,0 +1,114 @@
+#include "extensions/phal/callout.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace openpower::pel;
+using json = nlohmann::json;
+
+TEST(CalloutPriority, PhalPriorityMap)
+{
+    EXPECT_EQ(getPelPriority("HIGH"), CalloutPriority::High);
+    EXPECT_EQ(getPelPriority("MEDIUM"), CalloutPriority::Medium);
+    EXPECT_EQ(getPelPriority("LOW"), CalloutPriority::Low);
+    EXPECT_EQ(getPelPriority("NONE"), CalloutPriority::Low);
+
+    // Unsupported priorities are called out High
+    EXPECT_EQ(getPelPriority("UNKNOWN"), CalloutPriority::High);
+    EXPECT_EQ(getPelPriority("high"), CalloutPriority::High);
+    EXPECT_EQ(getPelPriority(""), CalloutPriority::High);
+}
+
+TEST(CalloutPriority, ToString)
+{
+    EXPECT_EQ(toString(CalloutPriority::High), "H");
+    EXPECT_EQ(toString(CalloutPriority::Medium), "M");
+    EXPECT_EQ(toString(CalloutPriority::Low), "L");
+}
+
+TEST(CalloutSort, StableOnEqualPriority)
+{
+    CalloutList callouts;
+    for (const auto& [name, priority] :
+         std::vector<std::pair<std::string, CalloutPriority>>{
+             {"low0", CalloutPriority::Low},
+             {"high0", CalloutPriority::High},
+             {"medium0", CalloutPriority::Medium},
+             {"low1", CalloutPriority::Low},
+             {"high1", CalloutPriority::High},
+             {"medium1", CalloutPriority::Medium},
+             {"high2", CalloutPriority::High}})
+    {
+        Callout callout;
+        callout.priority = priority;
+        callout.procedure = name;
+        callouts.push_back(callout);
+    }
+
+    sortByPriority(callouts);
+
+    std::vector<std::string> order;
+    for (const auto& callout : callouts)
+    {
+        order.push_back(*callout.procedure);
+    }
+    EXPECT_EQ(order,
+              (std::vector<std::string>{"high0", "high1", "high2", "medium0",
+                                        "medium1", "low0", "low1"}));
+}
+
+TEST(CalloutJson, UnsetFieldsOmitted)
+{
+    Callout callout;
+    callout.priority = CalloutPriority::Medium;
+
+    auto data = toJson({callout});
+
+    ASSERT_EQ(data.size(), 1u);
+    EXPECT_EQ(data[0], json({{"Priority", "M"}}));
+}
+
+TEST(CalloutJson, AllFields)
+{
+    Callout callout;
+    callout.priority = CalloutPriority::Low;
+    callout.procedure = "BMC0001";
+    callout.locationCode = "Ufcs-P0-C15";
+    callout.inventoryPath = "/xyz/openbmc_project/inventory/system/proc0";
+    callout.symbolicFRU = "CLKFRU";
+    callout.mruId = 0x1234;
+    callout.deconfigured = false;
+    callout.guarded = true;
+    callout.guardType = "GARD_Predictive";
+    callout.entityPath = std::vector<uint8_t>{0x01, 0x02};
+
+    auto data = toJson({callout});
+
+    json expected = {
+        {"Priority", "L"},
+        {"Procedure", "BMC0001"},
+        {"LocationCode", "Ufcs-P0-C15"},
+        {"InventoryPath", "/xyz/openbmc_project/inventory/system/proc0"},
+        {"SymbolicFRU", "CLKFRU"},
+        {"MRUs", json::array({{{"ID", 0x1234}, {"Priority", "L"}}})},
+        {"Deconfigured", false},
+        {"Guarded", true},
+        {"GuardType", "GARD_Predictive"},
+        {"EntityPath", {0x01, 0x02}},
+    };
+    ASSERT_EQ(data.size(), 1u);
+    EXPECT_EQ(data[0], expected);
+}
+
+TEST(CalloutJson, EmptyList)
+{
+    auto data = toJson({});
+
+    EXPECT_TRUE(data.is_array());
+    EXPECT_TRUE(data.empty());
+}
@@ -0,0 +1,148 @@
+#include "extensions/phal/pel_rate_limit.hpp"
+
+#include <stdlib.h>
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace openpower::pel;
+using json = nlohmann::json;
+
+namespace fs = std::filesystem;
+
+/** Rate limited to one PEL per 10 minutes, without keys */
+constexpr auto hostRunning = "org.open_power.PHAL.Error.HostRunning";
+
+/** Rate limited to one PEL per 10 minutes and SRC6 value */
+constexpr auto chipOpFailure =
+    "org.open_power.Processor.Error.SbeChipOpFailure";
+
+class PelRateLimitTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/pelRateLimitXXXXXX";
+        auto path = mkdtemp(dir);
+        ASSERT_NE(path, nullptr);
+        tmpDir = path;
+        historyFile = tmpDir / "history" / "pel_history.json";
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(tmpDir);
+    }
+
+    std::optional<uint32_t> check(const std::string& event,
+                                  Severity severity = Severity::Error,
+                                  const FFDCData& ffdcData = {})
+    {
+        return checkRateLimit(event, severity, ffdcData, historyFile);
+    }
+
+    /**
+     * @brief Move all the history windows into the past
+     */
+    void expireHistory()
+    {
+        json history;
+        std::ifstream(historyFile) >> history;
+        for (auto& entry : history)
+        {
+            entry["expires"] = 0;
+        }
+        std::ofstream(historyFile) << history.dump();
+    }
+
+    fs::path tmpDir;
+    fs::path historyFile;
+};
+
+TEST_F(PelRateLimitTest, NotRateLimited)
+{
+    EXPECT_EQ(check("org.open_power.PHAL.Error.Other"), 0u);
+    EXPECT_EQ(check("org.open_power.PHAL.Error.Other"), 0u);
+
+    // Wrong severity
+    EXPECT_EQ(check(hostRunning, Severity::Informational), 0u);
+    EXPECT_EQ(check(hostRunning, Severity::Informational), 0u);
+
+    // Without the policy key
+    EXPECT_EQ(check(chipOpFailure, Severity::Informational), 0u);
+    EXPECT_EQ(check(chipOpFailure, Severity::Informational), 0u);
+
+    EXPECT_FALSE(fs::exists(historyFile));
+}
+
+TEST_F(PelRateLimitTest, FirstAllowed)
+{
+    EXPECT_EQ(check(hostRunning), 0u);
+    EXPECT_TRUE(fs::exists(historyFile));
+}
+
+TEST_F(PelRateLimitTest, SuppressedWithinWindow)
+{
+    EXPECT_EQ(check(hostRunning), 0u);
+    EXPECT_EQ(check(hostRunning), std::nullopt);
+    EXPECT_EQ(check(hostRunning), std::nullopt);
+}
+
+TEST_F(PelRateLimitTest, DistinctKeys)
+{
+    FFDCData proc0 = {{"SRC6", "0x00000000"}};
+    FFDCData proc1 = {{"SRC6", "0x00010000"}};
+
+    EXPECT_EQ(check(chipOpFailure, Severity::Informational, proc0), 0u);
+    EXPECT_EQ(check(chipOpFailure, Severity::Informational, proc1), 0u);
+    EXPECT_EQ(check(chipOpFailure, Severity::Informational, proc0),
+              std::nullopt);
+    EXPECT_EQ(check(chipOpFailure, Severity::Informational, proc1),
+              std::nullopt);
+}
+
+TEST_F(PelRateLimitTest, WindowExpiry)
+{
+    EXPECT_EQ(check(hostRunning), 0u);
+    expireHistory();
+
+    EXPECT_EQ(check(hostRunning), 0u);
+    EXPECT_EQ(check(hostRunning), std::nullopt);
+}
+
+TEST_F(PelRateLimitTest, SuppressedCountReported)
+{
+    EXPECT_EQ(check(hostRunning), 0u);
+    EXPECT_EQ(check(hostRunning), std::nullopt);
+    EXPECT_EQ(check(hostRunning), std::nullopt);
+    expireHistory();
+
+    // Next allowed PEL carries the count, which is then reset
+    EXPECT_EQ(check(hostRunning), 2u);
+    expireHistory();
+    EXPECT_EQ(check(hostRunning), 0u);
+}
+
+TEST_F(PelRateLimitTest, CorruptHistory)
+{
+    fs::create_directories(historyFile.parent_path());
+    std::ofstream(historyFile) << "{\"truncated\": ";
+
+    // Never dropped, the history is started over
+    EXPECT_EQ(check(hostRunning), 0u);
+    EXPECT_EQ(check(hostRunning), std::nullopt);
+}
+
+TEST_F(PelRateLimitTest, HistoryNotWritable)
+{
+    // History errors never drop a PEL
+    historyFile = tmpDir;
+    EXPECT_EQ(check(hostRunning), 0u);
+    EXPECT_EQ(check(hostRunning), 0u);
+}
@@ -0,0 +1,390 @@
+#include "extensions/phal/preserved_attrs.hpp"
+
+#include <stdlib.h>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+using namespace openpower::phal::attrs;
+
+namespace fs = std::filesystem;
+
+class PreservedAttrsTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dir[] = "/tmp/preservedAttrsXXXXXX";
+        auto path = mkdtemp(dir);
+        ASSERT_NE(path, nullptr);
+        tmpDir = path;
+
+        container.attrNames = {"ATTR_A", "ATTR_B"};
+        container.targetPaths = {"/proc0", "/proc1"};
+        container.records = {{0, 0, {0x01, 0x02, 0x03, 0x04}},
+                             {1, 0, {}},
+                             {0, 1, {0xAA}}};
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(tmpDir);
+    }
+
+    /**
+     * @brief Serialize the container with a bad record index
+     *
+     * The header CRC still matches, so only the index check fails.
+     */
+    std::vector<uint8_t> serializeRecord(uint16_t attrId, uint16_t targetId)
+    {
+        container.records.push_back({attrId, targetId, {0x00}});
+        return serialize(container);
+    }
+
+    fs::path tmpDir;
+    Container container;
+};
+
+/** @brief Build a flattened devtree blob */
+class FdtBuilder
+{
+  public:
+    void beginNode(const std::string& name)
+    {
+        put(0x1);
+        structBlock.insert(structBlock.end(), name.begin(), name.end());
+        structBlock.push_back('\0');
+        align();
+    }
+
+    void endNode()
+    {
+        put(0x2);
+    }
+
+    void property(const std::string& name, const std::vector<uint8_t>& value,
+                  uint32_t nameOffset = UINT32_MAX)
+    {
+        if (nameOffset == UINT32_MAX)
+        {
+            nameOffset = strings.size();
+            strings += name;
+            strings += '\0';
+        }
+        put(0x3);
+        put(value.size());
+        put(nameOffset);
+        structBlock.insert(structBlock.end(), value.begin(), value.end());
+        align();
+    }
+
+    std::vector<uint8_t> build()
+    {
+        put(0x9);
+
+        constexpr uint32_t headerSize = 40;
+        std::vector<uint8_t> blob;
+        auto be32 = [&blob](uint32_t value) {
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                blob.push_back(value >> shift);
+            }
+        };
+        be32(0xD00DFEED);
+        be32(headerSize + structBlock.size() + strings.size());
+        be32(headerSize);
+        be32(headerSize + structBlock.size());
+        blob.resize(headerSize);
+
+        blob.insert(blob.end(), structBlock.begin(), structBlock.end());
+        blob.insert(blob.end(), strings.begin(), strings.end());
+        return blob;
+    }
+
+  private:
+    void put(uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            structBlock.push_back(value >> shift);
+        }
+    }
+
+    void align()
+    {
+        structBlock.resize((structBlock.size() + 3) & ~size_t(3));
+    }
+
+    std::vector<uint8_t> structBlock;
+    std::string strings;
+};
+
+/** Offset of the version field in the header */
+constexpr size_t versionOffset = offsetof(Header, version);
+
+TEST(PreservedAttrsCrc, KnownValues)
+{
+    constexpr std::string_view check = "123456789";
+    std::vector<uint8_t> data(check.begin(), check.end());
+
+    EXPECT_EQ(crc32(data), 0xCBF43926u);
+    EXPECT_EQ(crc32({}), 0u);
+}
+
+TEST_F(PreservedAttrsTest, RoundTrip)
+{
+    auto data = serialize(container);
+    auto result = deserialize(data);
+
+    EXPECT_EQ(result.attrNames, container.attrNames);
+    EXPECT_EQ(result.targetPaths, container.targetPaths);
+    ASSERT_EQ(result.records.size(), container.records.size());
+    for (size_t i = 0; i < result.records.size(); i++)
+    {
+        EXPECT_EQ(result.records[i].attrId, container.records[i].attrId);
+        EXPECT_EQ(result.records[i].targetId, container.records[i].targetId);
+        EXPECT_EQ(result.records[i].value, container.records[i].value);
+    }
+}
+
+TEST_F(PreservedAttrsTest, EmptyRoundTrip)
+{
+    auto result = deserialize(serialize(Container{}));
+
+    EXPECT_TRUE(result.attrNames.empty());
+    EXPECT_TRUE(result.targetPaths.empty());
+    EXPECT_TRUE(result.records.empty());
+}
+
+TEST_F(PreservedAttrsTest, FileRoundTrip)
+{
+    auto file = tmpDir / "attrs";
+    writeFile(file, container);
+
+    EXPECT_TRUE(isContainerFile(file));
+    EXPECT_FALSE(fs::exists(tmpDir / "attrs.tmp"));
+
+    auto result = readFile(file);
+    EXPECT_EQ(result.attrNames, container.attrNames);
+    EXPECT_EQ(result.targetPaths, container.targetPaths);
+    EXPECT_EQ(result.records.size(), container.records.size());
+}
+
+TEST_F(PreservedAttrsTest, Truncated)
+{
+    auto data = serialize(container);
+
+    auto payload = data;
+    payload.pop_back();
+    EXPECT_THROW(deserialize(payload), std::runtime_error);
+
+    auto header = data;
+    header.resize(sizeof(Header) - 1);
+    EXPECT_THROW(deserialize(header), std::runtime_error);
+
+    EXPECT_THROW(deserialize({}), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, TruncatedRecord)
+{
+    // Header consistent with the shorter payload, the last record value
+    // runs past the end.
+    auto data = serialize(container);
+    data.pop_back();
+
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    header.payloadSize--;
+    header.payloadCrc = crc32(std::span(data).subspan(sizeof(header)));
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, TrailingData)
+{
+    auto data = serialize(container);
+    data.push_back(0);
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, BadMagic)
+{
+    auto data = serialize(container);
+    data[0] ^= 0xFF;
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+
+    auto file = tmpDir / "attrs";
+    std::ofstream(file, std::ios::binary)
+        .write(reinterpret_cast<const char*>(data.data()), data.size());
+    EXPECT_FALSE(isContainerFile(file));
+    EXPECT_THROW(readFile(file), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, BadVersion)
+{
+    auto data = serialize(container);
+    uint16_t version = CONTAINER_VERSION + 1;
+    std::memcpy(data.data() + versionOffset, &version, sizeof(version));
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, CrcMismatch)
+{
+    auto data = serialize(container);
+    data.back() ^= 0x01;
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, AttrIndexOutOfRange)
+{
+    auto data = serializeRecord(container.attrNames.size(), 0);
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, TargetIndexOutOfRange)
+{
+    auto data = serializeRecord(0, container.targetPaths.size());
+
+    EXPECT_THROW(deserialize(data), std::runtime_error);
+}
+
+TEST_F(PreservedAttrsTest, MissingFile)
+{
+    EXPECT_FALSE(isContainerFile(tmpDir / "missing"));
+    EXPECT_THROW(readFile(tmpDir / "missing"), std::runtime_error);
+}
+
+class DevtreeBlobTest : public PreservedAttrsTest
+{
+  protected:
+    /**
+     * @brief Write the blob to a file and read the attributes from it
+     */
+    Values read(const std::vector<uint8_t>& blob,
+                const std::vector<std::string>& attrNames = {"ATTR_A",
+                                                             "ATTR_B"})
+    {
+        auto file = tmpDir / "devtree";
+        std::ofstream(file, std::ios::binary)
+            .write(reinterpret_cast<const char*>(blob.data()), blob.size());
+        return readDevtreeBlob(file, attrNames);
+    }
+
+    /**
+     * @brief Blob with a root attribute and a nested proc node
+     */
+    std::vector<uint8_t> validBlob()
+    {
+        FdtBuilder fdt;
+        fdt.beginNode("");
+        fdt.property("ATTR_A", {0x01});
+        fdt.property("compatible", {'i', 'b', 'm', '\0'});
+        fdt.beginNode("proc0");
+        fdt.property("ATTR_A", {0x01, 0x02, 0x03, 0x04, 0x05});
+        fdt.beginNode("core0");
+        fdt.property("ATTR_B", {});
+        fdt.endNode();
+        fdt.endNode();
+        fdt.endNode();
+        return fdt.build();
+    }
+};
+
+TEST_F(DevtreeBlobTest, ValidBlob)
+{
+    auto values = read(validBlob());
+
+    Values expected = {
+        {{"/", "ATTR_A"}, {0x01}},
+        {{"/proc0", "ATTR_A"}, {0x01, 0x02, 0x03, 0x04, 0x05}},
+        {{"/proc0/core0", "ATTR_B"}, {}},
+    };
+    EXPECT_EQ(values, expected);
+}
+
+TEST_F(DevtreeBlobTest, OnlyRequestedAttrs)
+{
+    auto values = read(validBlob(), {"ATTR_B"});
+
+    ASSERT_EQ(values.size(), 1u);
+    EXPECT_TRUE(values.contains({"/proc0/core0", "ATTR_B"}));
+}
+
+TEST_F(DevtreeBlobTest, TruncatedStruct)
+{
+    auto blob = validBlob();
+    for (size_t size : {size_t(2), size_t(40), size_t(46), size_t(60)})
+    {
+        EXPECT_THROW(read({blob.begin(), blob.begin() + size}),
+                     std::runtime_error);
+    }
+}
+
+TEST_F(DevtreeBlobTest, BadStringOffset)
+{
+    FdtBuilder fdt;
+    fdt.beginNode("");
+    fdt.property("ATTR_A", {0x01}, 0x10000);
+    fdt.endNode();
+
+    EXPECT_THROW(read(fdt.build()), std::runtime_error);
+}
+
+TEST_F(DevtreeBlobTest, BadMagic)
+{
+    auto blob = validBlob();
+    blob[0] ^= 0xFF;
+
+    EXPECT_THROW(read(blob), std::runtime_error);
+}
+
+TEST_F(DevtreeBlobTest, UnbalancedNodes)
+{
+    FdtBuilder fdt;
+    fdt.beginNode("");
+    fdt.endNode();
+    fdt.endNode();
+
+    EXPECT_THROW(read(fdt.build()), std::runtime_error);
+}
+
+TEST_F(DevtreeBlobTest, MissingFile)
+{
+    EXPECT_THROW(readDevtreeBlob(tmpDir / "missing", {"ATTR_A"}),
+                 std::runtime_error);
+}
+
+TEST(PreservedAttrsChanged, ChangedAttrs)
+{
+    Values baseline = {
+        {{"/proc0", "ATTR_A"}, {0x01}},
+        {{"/proc1", "ATTR_A"}, {0x01}},
+        {{"/proc0", "ATTR_B"}, {0x02}},
+        {{"/proc0", "ATTR_C"}, {0x03}},
+    };
+
+    EXPECT_TRUE(changedAttrs(baseline, baseline).empty());
+
+    auto values = baseline;
+    values[{"/proc1", "ATTR_A"}] = {0x02};
+    values[{"/proc1", "ATTR_C"}] = {0x03};
+    EXPECT_EQ(changedAttrs(values, baseline),
+              (std::vector<std::string>{"ATTR_A", "ATTR_C"}));
+
+    EXPECT_EQ(changedAttrs(baseline, {}),
+              (std::vector<std::string>{"ATTR_A", "ATTR_B", "ATTR_C"}));
+}
@@ -1,9 +1,19 @@
 #include "util.hpp"
 
+#include <unistd.h>
+
 #include <phosphor-logging/elog.hpp>
+#include <sdbusplus/bus/match.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <format>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <tuple>
 #include <variant>
 #include <vector>
 
@@ -13,9 +23,161 @@ namespace util
 {
 using namespace phosphor::logging;
 
+/** The getBus() connection, once constructed */
+static std::atomic<sdbusplus::bus_t*> sharedBus = nullptr;
+
+sdbusplus::bus_t& getBus()
+{
+    static pid_t owner = getpid();
+    static auto bus = sdbusplus::bus::new_default();
+    sharedBus = &bus;
+
+    // sd-bus connections can't be used across fork(), so a forked child
+    // gets its own connection. new_default() would return the cached
+    // default connection inherited from the parent, open a fresh one.
+    if (owner != getpid())
+    {
+        owner = getpid();
+        bus = sdbusplus::bus::new_system();
+    }
+    return bus;
+}
+
+/**
+ * @brief Mapper lookup results shared by all the getService() callers
+ */
+struct ServiceCache
+{
+    struct Entry
+    {
+        std::string service;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    std::mutex lock;
+    std::map<std::pair<std::string, std::string>, Entry> entries;
+
+    /**
+     * @brief Drop all the entries which resolve to the service
+     *
+     * @param[in] service - service name
+     */
+    void dropService(const std::string& service)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::erase_if(entries, [&service](const auto& entry) {
+            return entry.second.service == service;
+        });
+    }
+
+    /**
+     * @brief Drop the entries of the removed interfaces of the object
+     *
+     * @param[in] msg - InterfacesRemoved signal
+     */
+    void interfacesRemoved(sdbusplus::message_t& msg)
+    {
+        sdbusplus::message::object_path path;
+        std::vector<std::string> interfaces;
+        msg.read(path, interfaces);
+
+        std::lock_guard<std::mutex> guard(lock);
+        for (const auto& interface : interfaces)
+        {
+            entries.erase({path.str, interface});
+        }
+    }
+};
+
+static ServiceCache& getServiceCache()
+{
+    // Doesn't construct the getBus() connection, getService() is also
+    // called with the private connections of worker threads.
+    static ServiceCache cache;
+    return cache;
+}
+
+/**
+ * @brief Invalidation signal matches of the service cache
+ */
+struct ServiceWatch
+{
+    /** Signal matches of one service */
+    struct Matches
+    {
+        std::unique_ptr<sdbusplus::bus::match_t> ownerMatch;
+        std::unique_ptr<sdbusplus::bus::match_t> removedMatch;
+    };
+
+    /** Matches keyed by service name */
+    std::map<std::string, Matches> services;
+
+    /**
+     * @brief Subscribe to the invalidation signals of the service
+     *
+     * Only done on the shared connection, when the process dispatches it
+     * from an event loop. The InterfacesRemoved match is limited to the
+     * signals sent by the service, so the process isn't woken up by the
+     * objects of the other services. Caller must hold the cache lock.
+     *
+     * @param[in] bus - shared D-Bus connection
+     * @param[in] cache - service cache to invalidate
+     * @param[in] service - service name to watch
+     */
+    void watch(sdbusplus::bus_t& bus, ServiceCache& cache,
+               const std::string& service)
+    {
+        namespace rules = sdbusplus::bus::match::rules;
+
+        if (services.contains(service))
+        {
+            return;
+        }
+        auto& matches = services[service];
+        matches.ownerMatch = std::make_unique<sdbusplus::bus::match_t>(
+            bus, rules::nameOwnerChanged(service),
+            [&cache, service](sdbusplus::message_t&) {
+            cache.dropService(service);
+        });
+        matches.removedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            bus, rules::interfacesRemoved() + rules::sender(service),
+            [&cache](sdbusplus::message_t& msg) {
+            cache.interfacesRemoved(msg);
+        });
+    }
+};
+
+/**
+ * @brief Get the service cache matches
+ *
+ * Constructed after the getBus() connection and the service cache, so
+ * the matches are destroyed before both of them.
+ *
+ * @return service cache matches
+ */
+static ServiceWatch& getServiceWatch()
+{
+    getBus();
+    getServiceCache();
+    static ServiceWatch watch;
+    return watch;
+}
+
+
 std::string getService(sdbusplus::bus_t& bus, const std::string& objectPath,
                        const std::string& interface)
 {
+    auto& cache = getServiceCache();
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> guard(cache.lock);
+        auto it = cache.entries.find({objectPath, interface});
+        if ((it != cache.entries.end()) && (it->second.expires > now))
+        {
+            return it->second.service;
+        }
+    }
+
     constexpr auto mapperBusBame = "xyz.openbmc_project.ObjectMapper";
     constexpr auto mapperObjectPath = "/xyz/openbmc_project/object_mapper";
     constexpr auto mapperInterface = "xyz.openbmc_project.ObjectMapper";
@@ -42,7 +204,198 @@ std::string getService(sdbusplus::bus_t& bus, const std::string& objectPath,
     {
         throw std::runtime_error("Service name response is empty");
     }
-    return response.begin()->first;
+
+    const auto& service = response.begin()->first;
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.entries.insert_or_assign(
+        std::make_pair(objectPath, interface),
+        ServiceCache::Entry{service, now + SERVICE_CACHE_TTL});
+    // Compared without calling getBus(), which would construct the
+    // shared connection on the calling thread, e.g. the PEL queue worker.
+    // Without an event loop the signals are never dispatched, the entry
+    // then only expires with SERVICE_CACHE_TTL.
+    if ((&bus == sharedBus) && (bus.get_event() != nullptr))
+    {
+        getServiceWatch().watch(bus, cache, service);
+    }
+    return service;
+}
+
+/**
+ * @brief D-Bus properties shared by all the getProperty() callers
+ *
+ * Only used when the shared connection is attached to an event loop,
+ * which dispatches the signals keeping the entries current.
+ */
+struct PropertyCache
+{
+    /** Service, object path and interface */
+    using Key = std::tuple<std::string, std::string, std::string>;
+
+    /** Cached properties of one object interface */
+    struct Entry
+    {
+        std::map<std::string, PropertyValue> properties;
+        std::unique_ptr<sdbusplus::bus::match_t> changedMatch;
+        std::unique_ptr<sdbusplus::bus::match_t> ownerMatch;
+
+        /**
+         * Set when the properties can't be trusted anymore. The entry is
+         * fetched again on next read, instead of being dropped from the
+         * match callback, which would destroy the running match.
+         */
+        bool stale = false;
+    };
+
+    std::mutex lock;
+    std::map<Key, Entry> entries;
+
+    /**
+     * @brief Mark the cache entry stale
+     *
+     * @param[in] key - service, object path and interface
+     */
+    void invalidate(const Key& key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            it->second.stale = true;
+        }
+    }
+
+    /**
+     * @brief Apply a PropertiesChanged signal to the cache entry
+     *
+     * @param[in] key - service, object path and interface
+     * @param[in] msg - PropertiesChanged signal
+     */
+    void propertiesChanged(const Key& key, sdbusplus::message_t& msg)
+    {
+        std::string changedInterface;
+        std::map<std::string, PropertyValue> changed;
+        try
+        {
+            msg.read(changedInterface, changed);
+        }
+        catch (const std::exception& e)
+        {
+            invalidate(key);
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            for (auto& [name, value] : changed)
+            {
+                it->second.properties.insert_or_assign(name, std::move(value));
+            }
+        }
+    }
+
+    /**
+     * @brief Fetch all the properties of the interface and subscribe
+     *        to their changes
+     *
+     * Caller must hold the lock. The method calls don't dispatch the
+     * signals, so the match callbacks can't run in between.
+     *
+     * @param[in] bus - shared D-Bus connection
+     * @param[in] key - service, object path and interface
+     *
+     * @return cache entry
+     */
+    Entry& add(sdbusplus::bus_t& bus, const Key& key)
+    {
+        const auto& [service, objectPath, interface] = key;
+
+        Entry entry;
+
+        // Subscribe before GetAll, so no change is missed in between
+        entry.changedMatch = std::make_unique<sdbusplus::bus::match_t>(
+            bus,
+            sdbusplus::bus::match::rules::propertiesChanged(objectPath,
+                                                            interface),
+            [this, key](sdbusplus::message_t& msg) {
+            propertiesChanged(key, msg);
+        });
+        entry.ownerMatch = std::make_unique<sdbusplus::bus::match_t>(
+            bus, sdbusplus::bus::match::rules::nameOwnerChanged(service),
+            [this, key](sdbusplus::message_t&) { invalidate(key); });
+
+        auto method = bus.new_method_call(service.c_str(), objectPath.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "GetAll");
+        method.append(interface);
+        auto reply = bus.call(method);
+        reply.read(entry.properties);
+
+        return entries.insert_or_assign(key, std::move(entry)).first->second;
+    }
+};
+
+/**
+ * @brief Get the process wide property cache
+ *
+ * The cache matches are on the getBus() connection, which is constructed
+ * first so it is destroyed after the cache.
+ *
+ * @return property cache
+ */
+static PropertyCache& getPropertyCache()
+{
+    getBus();
+    static PropertyCache cache;
+    return cache;
+}
+
+PropertyValue getProperty(const std::string& service,
+                          const std::string& objectPath,
+                          const std::string& interface,
+                          const std::string& property)
+{
+    auto& bus = getBus();
+
+    // Nothing would dispatch the PropertiesChanged signals of a bus
+    // without event loop, subscribing would only cost extra calls.
+    if (bus.get_event() == nullptr)
+    {
+        PropertyValue value;
+        auto method = bus.new_method_call(service.c_str(), objectPath.c_str(),
+                                          "org.freedesktop.DBus.Properties",
+                                          "Get");
+        method.append(interface, property);
+        auto reply = bus.call(method);
+        reply.read(value);
+        return value;
+    }
+
+    auto& cache = getPropertyCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+
+    auto key = std::make_tuple(service, objectPath, interface);
+    auto it = cache.entries.find(key);
+    auto& entry = ((it != cache.entries.end()) && !it->second.stale)
+                      ? it->second
+                      : cache.add(bus, key);
+
+    auto value = entry.properties.find(property);
+    if (value == entry.properties.end())
+    {
+        throw std::runtime_error(
+            std::format("Property({}) not found in interface({}) of object({})",
+                        property, interface, objectPath));
+    }
+    return value->second;
+}
+
+void initBus()
+{
+    getServiceWatch();
+    getPropertyCache();
 }
 
 bool isHostPoweringOff()
@@ -53,15 +406,8 @@ bool isHostPoweringOff()
         constexpr auto service = "xyz.openbmc_project.State.Host";
         constexpr auto interface = "xyz.openbmc_project.State.Host";
         constexpr auto property = "CurrentHostState";
-        auto bus = sdbusplus::bus::new_default();
 
-        std::variant<std::string> retval;
-        auto properties = bus.new_method_call(
-            service, object, "org.freedesktop.DBus.Properties", "Get");
-        properties.append(interface);
-        properties.append(property);
-        auto result = bus.call(properties);
-        result.read(retval);
+        auto retval = getProperty(service, object, interface, property);
 
         const std::string* state = std::get_if<std::string>(&retval);
         if (state == nullptr)
@@ -96,16 +442,10 @@ std::string getChassisPowerState()
     std::string powerState{};
     try
     {
-        auto bus = sdbusplus::bus::new_default();
-        auto properties =
-            bus.new_method_call("xyz.openbmc_project.State.Chassis",
-                                "/xyz/openbmc_project/state/chassis0",
-                                "org.freedesktop.DBus.Properties", "Get");
-        properties.append("xyz.openbmc_project.State.Chassis");
-        properties.append("CurrentPowerState");
-        auto result = bus.call(properties);
-        std::variant<std::string> val;
-        result.read(val);
+        auto val = getProperty("xyz.openbmc_project.State.Chassis",
+                               "/xyz/openbmc_project/state/chassis0",
+                               "xyz.openbmc_project.State.Chassis",
+                               "CurrentPowerState");
         if (auto pVal = std::get_if<std::string>(&val))
         {
             powerState = *pVal;
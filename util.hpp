@@ -2,15 +2,49 @@
 
 #include <sdbusplus/bus.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <variant>
+#include <vector>
 
 namespace openpower
 {
 namespace util
 {
+/**
+ * Get the process wide D-Bus connection
+ *
+ * The default bus connection is created on first use and then shared
+ * by all the D-Bus users of the process, instead of each caller paying
+ * for its own connection setup. A forked child gets a new connection on
+ * its first use.
+ *
+ * @return sdbusplus D-Bus connection
+ */
+sdbusplus::bus_t& getBus();
+
+/**
+ * Construct the shared D-Bus connection and the lookup caches
+ *
+ * Static objects are destroyed after the atexit handlers registered once
+ * they were constructed. An object which uses the connection or the
+ * caches from an atexit handler calls this before registering it, so
+ * they are still alive when the handler runs.
+ */
+void initBus();
+
+/** How long a mapper lookup result is trusted */
+constexpr std::chrono::seconds SERVICE_CACHE_TTL{60};
+
 /**
  * Get D-Bus service name for the specified object and interface
  *
+ * The mapper lookup result is cached for SERVICE_CACHE_TTL. When the
+ * shared connection returned by getBus() is attached to an event loop,
+ * the cache entries are also dropped on NameOwnerChanged of the service
+ * and InterfacesRemoved of the object.
+ *
  * @param[in] bus - sdbusplus D-Bus to attach to
  * @param[in] objectPath - D-Bus object path
  * @param[in] interface - D-Bus interface name
@@ -20,6 +54,48 @@ namespace util
 std::string getService(sdbusplus::bus_t& bus, const std::string& objectPath,
                        const std::string& interface);
 
+using PropertyValue =
+    std::variant<bool, uint8_t, int32_t, uint32_t, int64_t, uint64_t, double,
+                 std::string, std::vector<std::string>>;
+
+/**
+ * Get D-Bus property value, through the process wide property cache
+ * when the getBus() connection is attached to an event loop
+ *
+ * With an event loop, all the properties of the interface are fetched
+ * with one GetAll call on first use, and then kept current through a
+ * PropertiesChanged match dispatched by the loop. The cache entry is
+ * refetched when the service owner changes. Without an event loop, as
+ * in one-shot processes, the property is read with a plain Get call.
+ * The cache is locked, callers on other threads still share the
+ * getBus() connection and must not use it concurrently.
+ *
+ * Throws std::exception on failure, including an unknown property.
+ *
+ * @param[in] service - D-Bus service name
+ * @param[in] objectPath - D-Bus object path
+ * @param[in] interface - D-Bus interface name
+ * @param[in] property - property name
+ *
+ * @return property value
+ */
+PropertyValue getProperty(const std::string& service,
+                          const std::string& objectPath,
+                          const std::string& interface,
+                          const std::string& property);
+
+/**
+ * Get D-Bus property value of the given type, see getProperty()
+ *
+ * Throws std::bad_variant_access if the property has another type.
+ */
+template <typename T>
+T getProperty(const std::string& service, const std::string& objectPath,
+              const std::string& interface, const std::string& property)
+{
+    return std::get<T>(getProperty(service, objectPath, interface, property));
+}
+
 /**
  * Returns true if host is in poweringoff state else false
  *